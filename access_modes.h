@@ -0,0 +1,67 @@
+#pragma once
+#ifndef WTF_ACCESS_MODES
+#define WTF_ACCESS_MODES
+
+#include <cstdint>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+/* What a traversal does with each visited element.
+ *
+ * Reads keep cache lines clean, writes and read-modify-writes dirty them (and writes still pay for read-for-ownership),
+ * streaming stores bypass the cache entirely.
+ */
+enum class access_mode {
+    read,
+    write,
+    read_modify_write,
+    streaming_store
+};
+
+template <access_mode Mode>
+struct element_access;
+
+template <>
+struct element_access<access_mode::read> {
+    static void apply(int& element, int, std::uint32_t& acc){
+        acc += element;
+    }
+    static void finish(){}
+};
+
+template <>
+struct element_access<access_mode::write> {
+    static void apply(int& element, int value, std::uint32_t&){
+        element = value;
+    }
+    static void finish(){}
+};
+
+template <>
+struct element_access<access_mode::read_modify_write> {
+    static void apply(int& element, int value, std::uint32_t&){
+        element += value;
+    }
+    static void finish(){}
+};
+
+//Without SSE2 there is no non-temporal store to use, so this degrades into plain write.
+template <>
+struct element_access<access_mode::streaming_store> {
+    static void apply(int& element, int value, std::uint32_t&){
+#if defined(__SSE2__)
+        _mm_stream_si32(&element, value);
+#else
+        element = value;
+#endif
+    }
+    static void finish(){
+#if defined(__SSE2__)
+        _mm_sfence();
+#endif
+    }
+};
+
+#endif
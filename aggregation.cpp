@@ -0,0 +1,87 @@
+#include <algorithm>
+
+#include "aggregation.h"
+#include "hash_table.h"
+
+namespace {
+
+//Smallest number of partition bits, for which a partition's table fits into partition_table_bytes.
+std::size_t bits_for(std::size_t distinct){
+    std::size_t partition_bits = 0;
+    while ((distinct >> partition_bits) * 2 * sizeof(aggregation_table::slot) > partition_table_bytes){
+        ++partition_bits;
+    }
+    return partition_bits;
+}
+
+}
+
+global_aggregator::global_aggregator(std::size_t distinct)
+:table(distinct){}
+
+std::size_t global_aggregator::operator()(const aggregation_input& input){
+    table.clear();
+    for (const auto& pair : input){
+        table[pair.first] += pair.second;
+    }
+    return table.size();
+}
+
+partitioned_aggregator::partitioned_aggregator(std::size_t max_size, std::size_t distinct)
+:partition_bits(bits_for(distinct)),
+ scratch{aggregation_input(max_size), aggregation_input(max_size)},
+ table(std::max<std::size_t>(distinct >> partition_bits, 1)){}
+
+std::size_t partitioned_aggregator::operator()(const aggregation_input& input){
+    const std::size_t n = input.size();
+
+    //Partitions are taken from the highest bits of the hash, because the tables use the lowest ones.
+    const aggregation_input::value_type* from = input.data();
+    std::vector<std::size_t> bounds = {0, n};
+    std::size_t shift = 32;
+    int target = 0;
+    for (auto remaining = partition_bits; remaining > 0; ){
+        const auto bits = std::min(remaining, partition_fanout_bits);
+        const std::size_t fanout = std::size_t(1) << bits;
+        remaining -= bits;
+        shift -= bits;
+
+        auto to = scratch[target].data();
+        std::vector<std::size_t> next_bounds;
+        next_bounds.reserve((bounds.size() - 1) * fanout + 1);
+        std::vector<std::size_t> offsets(fanout);
+        for (std::size_t p = 0; p + 1 < bounds.size(); ++p){
+            std::fill(begin(offsets), end(offsets), 0);
+            for (auto i = bounds[p]; i < bounds[p + 1]; ++i){
+                ++offsets[(hash_key(from[i].first) >> shift) & (fanout - 1)];
+            }
+
+            auto running = bounds[p];
+            for (auto& offset : offsets){
+                next_bounds.push_back(running);
+                auto temp = offset;
+                offset = running;
+                running += temp;
+            }
+
+            for (auto i = bounds[p]; i < bounds[p + 1]; ++i){
+                to[offsets[(hash_key(from[i].first) >> shift) & (fanout - 1)]++] = from[i];
+            }
+        }
+        next_bounds.push_back(n);
+
+        bounds.swap(next_bounds);
+        from = to;
+        target ^= 1;
+    }
+
+    std::size_t total = 0;
+    for (std::size_t p = 0; p + 1 < bounds.size(); ++p){
+        table.clear();
+        for (auto i = bounds[p]; i < bounds[p + 1]; ++i){
+            table[from[i].first] += from[i].second;
+        }
+        total += table.size();
+    }
+    return total;
+}
@@ -0,0 +1,54 @@
+#pragma once
+#ifndef WTF_AGGREGATION
+#define WTF_AGGREGATION
+
+#include <vector>
+#include <utility>
+#include <cstdint>
+
+#include "hash_table.h"
+
+using aggregation_input = std::vector<std::pair<std::uint32_t, std::uint32_t>>;
+
+constexpr std::size_t partition_fanout_bits = 6; //64 outputs per pass, so that every output stays within TLB reach.
+constexpr std::size_t partition_table_bytes = 256 * 1024; //Per partition hash table should fit into L2.
+
+using aggregation_table = linear_probing_map<std::uint32_t, std::uint32_t>;
+
+/* Sums values per key, in a single hash table for all of the keys.
+ *
+ * The table is allocated up front for given number of distinct keys and only cleared by every call,
+ * same as the per partition table of partitioned_aggregator, so that neither one times page faults.
+ */
+class global_aggregator {
+public:
+    explicit global_aggregator(std::size_t distinct);
+
+    //Returns the number of distinct keys seen.
+    std::size_t operator()(const aggregation_input& input);
+
+private:
+    aggregation_table table;
+};
+
+/* Sums values per key, after radix partitioning the input by the hash of the key.
+ *
+ * Partitioning takes as many passes of partition_fanout_bits as needed for each partition's
+ * hash table to fit into partition_table_bytes, then every partition is aggregated separately.
+ * Partitioning buffers and the per partition table are allocated up front, so that the page faults
+ * are not part of the measurement, same as for global_aggregator.
+ */
+class partitioned_aggregator {
+public:
+    partitioned_aggregator(std::size_t max_size, std::size_t distinct);
+
+    //Returns the number of distinct keys seen.
+    std::size_t operator()(const aggregation_input& input);
+
+private:
+    std::size_t partition_bits;
+    aggregation_input scratch[2];
+    aggregation_table table;
+};
+
+#endif
@@ -0,0 +1,57 @@
+#pragma once
+#ifndef WTF_ALIGNED_ALLOCATOR
+#define WTF_ALIGNED_ALLOCATOR
+
+#include <cstddef>
+#include <new>
+#include <stdlib.h>
+
+#include "allocation_tracking.h"
+
+constexpr std::size_t cache_line_size = 64;
+
+/* Minimal allocator handing out memory aligned to Align bytes, so that containers can start at a cache line boundary.
+ *
+ * Uses posix_memalign, because std::aligned_alloc is not available in C++11.
+ * That bypasses operator new, so the memory is reported to allocation tracking explicitly.
+ */
+template <typename T, std::size_t Align = cache_line_size>
+class aligned_allocator {
+public:
+    using value_type = T;
+
+    template <typename U>
+    struct rebind {
+        using other = aligned_allocator<U, Align>;
+    };
+
+    aligned_allocator(){}
+    template <typename U>
+    aligned_allocator(const aligned_allocator<U, Align>&){}
+
+    T* allocate(std::size_t count){
+        void* ptr = nullptr;
+        if (posix_memalign(&ptr, Align, count * sizeof(T)) != 0){
+            throw std::bad_alloc();
+        }
+        record_allocation(count * sizeof(T));
+        return static_cast<T*>(ptr);
+    }
+
+    void deallocate(T* ptr, std::size_t count){
+        record_deallocation(count * sizeof(T));
+        free(ptr);
+    }
+};
+
+template <typename T, typename U, std::size_t Align>
+bool operator==(const aligned_allocator<T, Align>&, const aligned_allocator<U, Align>&){
+    return true;
+}
+
+template <typename T, typename U, std::size_t Align>
+bool operator!=(const aligned_allocator<T, Align>&, const aligned_allocator<U, Align>&){
+    return false;
+}
+
+#endif
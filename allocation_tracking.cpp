@@ -0,0 +1,134 @@
+#include "allocation_tracking.h"
+
+#ifdef WTF_TRACK_ALLOCATIONS
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+namespace {
+
+std::atomic<std::uint64_t> allocation_count{0};
+std::atomic<std::uint64_t> allocated_bytes{0};
+std::atomic<std::int64_t> live_bytes{0};
+std::atomic<std::int64_t> peak_live_bytes{0};
+
+//Keeps the block that is handed out aligned for any fundamental type.
+constexpr std::size_t header_size = alignof(std::max_align_t);
+
+void* tracked_allocate(std::size_t size){
+    void* block = std::malloc(size + header_size);
+    if (!block){
+        return nullptr;
+    }
+    *static_cast<std::size_t*>(block) = size;
+    record_allocation(size);
+    return static_cast<char*>(block) + header_size;
+}
+
+void tracked_deallocate(void* ptr){
+    if (!ptr){
+        return;
+    }
+    void* block = static_cast<char*>(ptr) - header_size;
+    record_deallocation(*static_cast<std::size_t*>(block));
+    std::free(block);
+}
+
+void* throwing_allocate(std::size_t size){
+    for (;;){
+        if (auto ptr = tracked_allocate(size)){
+            return ptr;
+        }
+        auto handler = std::get_new_handler();
+        if (!handler){
+            throw std::bad_alloc();
+        }
+        handler();
+    }
+}
+
+}
+
+void record_allocation(std::size_t bytes){
+    allocation_count.fetch_add(1, std::memory_order_relaxed);
+    allocated_bytes.fetch_add(bytes, std::memory_order_relaxed);
+    auto live = live_bytes.fetch_add(bytes, std::memory_order_relaxed) + static_cast<std::int64_t>(bytes);
+    auto peak = peak_live_bytes.load(std::memory_order_relaxed);
+    while (live > peak && !peak_live_bytes.compare_exchange_weak(peak, live, std::memory_order_relaxed)){}
+}
+
+void record_deallocation(std::size_t bytes){
+    live_bytes.fetch_sub(bytes, std::memory_order_relaxed);
+}
+
+void* operator new(std::size_t size){
+    return throwing_allocate(size);
+}
+
+void* operator new[](std::size_t size){
+    return throwing_allocate(size);
+}
+
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept {
+    return tracked_allocate(size);
+}
+
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept {
+    return tracked_allocate(size);
+}
+
+void operator delete(void* ptr) noexcept {
+    tracked_deallocate(ptr);
+}
+
+void operator delete[](void* ptr) noexcept {
+    tracked_deallocate(ptr);
+}
+
+void operator delete(void* ptr, std::size_t) noexcept {
+    tracked_deallocate(ptr);
+}
+
+void operator delete[](void* ptr, std::size_t) noexcept {
+    tracked_deallocate(ptr);
+}
+
+void operator delete(void* ptr, const std::nothrow_t&) noexcept {
+    tracked_deallocate(ptr);
+}
+
+void operator delete[](void* ptr, const std::nothrow_t&) noexcept {
+    tracked_deallocate(ptr);
+}
+
+allocation_scope::allocation_scope()
+:start_count{allocation_count.load(std::memory_order_relaxed)},
+ start_bytes{allocated_bytes.load(std::memory_order_relaxed)},
+ start_live{live_bytes.load(std::memory_order_relaxed)}{
+    peak_live_bytes.store(start_live, std::memory_order_relaxed);
+}
+
+allocation_stats allocation_scope::stats() const {
+    allocation_stats result;
+    result.count = allocation_count.load(std::memory_order_relaxed) - start_count;
+    result.bytes = allocated_bytes.load(std::memory_order_relaxed) - start_bytes;
+    result.retained = live_bytes.load(std::memory_order_relaxed) - start_live;
+    auto peak = peak_live_bytes.load(std::memory_order_relaxed) - start_live;
+    result.peak = peak > 0 ? static_cast<std::uint64_t>(peak) : 0;
+    return result;
+}
+
+#else
+
+void record_allocation(std::size_t){}
+void record_deallocation(std::size_t){}
+
+allocation_scope::allocation_scope()
+:start_count{0}, start_bytes{0}, start_live{0}{}
+
+allocation_stats allocation_scope::stats() const {
+    return allocation_stats();
+}
+
+#endif
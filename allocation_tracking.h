@@ -0,0 +1,64 @@
+#pragma once
+#ifndef WTF_ALLOCATION_TRACKING
+#define WTF_ALLOCATION_TRACKING
+
+#include <cstdint>
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+/* Accounting of all allocations done through global operator new and delete.
+ *
+ * The replacement operators live in allocation_tracking.cpp and keep the requested size in a small header
+ * in front of every block, so that deallocation knows how many bytes stopped being live.
+ * That header moves blocks into bigger malloc size classes and every allocation updates shared counters,
+ * which changes exactly the memory layout the other benchmarks measure. So tracking is opt-in, only builds
+ * defining WTF_TRACK_ALLOCATIONS (the Footprint target) replace the operators, elsewhere all the stats stay zero.
+ */
+
+#ifdef WTF_TRACK_ALLOCATIONS
+constexpr bool allocation_tracking_enabled = true;
+#else
+constexpr bool allocation_tracking_enabled = false;
+#endif
+
+//For allocators that bypass operator new, like aligned_allocator, so that their memory is accounted for as well.
+void record_allocation(std::size_t bytes);
+void record_deallocation(std::size_t bytes);
+
+struct allocation_stats {
+    std::uint64_t count = 0;
+    std::uint64_t bytes = 0;     //Requested, without the bookkeeping header.
+    std::int64_t retained = 0;   //Live at the end of the scope, minus live at its start.
+    std::uint64_t peak = 0;      //Peak live bytes during the scope, above live bytes at its start.
+};
+
+/* Collects allocation_stats from construction until stats is called.
+ *
+ * Peak tracking is global, so scopes must not nest or overlap.
+ */
+class allocation_scope {
+public:
+    allocation_scope();
+
+    allocation_stats stats() const;
+
+private:
+    std::uint64_t start_count;
+    std::uint64_t start_bytes;
+    std::int64_t start_live;
+};
+
+/* Space cost of one measured container, at one size.
+ *
+ * Setup is constructing the container, timed is everything done within the measured region, over all repetitions.
+ */
+struct footprint {
+    std::size_t elements = 0;
+    allocation_stats setup;
+    allocation_stats timed;
+};
+
+using footprints = std::vector<std::pair<int, footprint>>;
+
+#endif
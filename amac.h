@@ -0,0 +1,209 @@
+#pragma once
+#ifndef WTF_AMAC
+#define WTF_AMAC
+
+#include <array>
+#include <algorithm>
+#include <vector>
+#include <utility>
+
+#include "flatmap.h"
+#include "hash_table.h"
+
+constexpr std::size_t max_lookup_group = 32;
+
+inline void prefetch_line(const void* address){
+#if defined(__GNUC__)
+    __builtin_prefetch(address);
+#else
+    (void)address;
+#endif
+}
+
+/* Lookup state machines, used by interleaved_find.
+ *
+ * start begins a lookup of key and prefetches its first probe. Every step then uses the probe
+ * that was prefetched before, prefetches the next one and returns true once the lookup is finished.
+ * result points to the value found, or is nullptr if the key is missing.
+ */
+template <typename Container>
+class lookup_cursor;
+
+/* Branchless lower bound over a sorted range, Projection extracts the key and the value from an element.
+ */
+template <typename T, typename Projection>
+class binary_search_cursor {
+public:
+    using key_type = decltype(Projection::key(std::declval<const T&>()));
+    using result_type = decltype(&Projection::value(std::declval<const T&>()));
+
+    void start(const T* first, std::size_t size, key_type k){
+        base = first;
+        last = first + size;
+        length = size;
+        key = k;
+        found = nullptr;
+        prefetch_line(base + length / 2);
+    }
+
+    bool step(){
+        if (length > 1){
+            auto half = length / 2;
+            base = Projection::key(base[half]) < key ? base + half : base;
+            length -= half;
+            prefetch_line(base + length / 2);
+            return false;
+        }
+        if (length == 1){
+            if (Projection::key(*base) < key){
+                ++base;
+            }
+            if (base != last && Projection::key(*base) == key){
+                found = &Projection::value(*base);
+            }
+        }
+        return true;
+    }
+
+    result_type result() const {
+        return found;
+    }
+
+private:
+    const T* base = nullptr;
+    const T* last = nullptr;
+    std::size_t length = 0;
+    key_type key{};
+    result_type found = nullptr;
+};
+
+template <typename T>
+struct element_projection {
+    static T key(const T& elem){
+        return elem;
+    }
+    static const T& value(const T& elem){
+        return elem;
+    }
+};
+
+template <typename Key, typename Value>
+struct pair_projection {
+    static Key key(const std::pair<Key, Value>& elem){
+        return elem.first;
+    }
+    static const Value& value(const std::pair<Key, Value>& elem){
+        return elem.second;
+    }
+};
+
+//Sorted vector, the elements are both the keys and the values.
+template <typename T>
+class lookup_cursor<std::vector<T>> : public binary_search_cursor<T, element_projection<T>> {
+public:
+    void start(const std::vector<T>& data, const T& key){
+        binary_search_cursor<T, element_projection<T>>::start(data.data(), data.size(), key);
+    }
+};
+
+template <typename Key, typename Value>
+class lookup_cursor<flatmap<Key, Value>> : public binary_search_cursor<std::pair<Key, Value>, pair_projection<Key, Value>> {
+public:
+    void start(const flatmap<Key, Value>& data, const Key& key){
+        auto size = static_cast<std::size_t>(data.end() - data.begin());
+        binary_search_cursor<std::pair<Key, Value>, pair_projection<Key, Value>>::start(size ? &*data.begin() : nullptr, size, key);
+    }
+};
+
+template <typename Key, typename Value>
+class lookup_cursor<linear_probing_map<Key, Value>> {
+public:
+    void start(const linear_probing_map<Key, Value>& data, const Key& k){
+        slots = data.data();
+        mask = data.bucket_mask();
+        key = k;
+        pos = hash_key(key) & mask;
+        found = nullptr;
+        prefetch_line(slots + pos);
+    }
+
+    bool step(){
+        const auto& s = slots[pos];
+        if (!s.occupied){
+            return true;
+        }
+        if (s.key == key){
+            found = &s.value;
+            return true;
+        }
+        pos = (pos + 1) & mask;
+        prefetch_line(slots + pos);
+        return false;
+    }
+
+    const Value* result() const {
+        return found;
+    }
+
+private:
+    const typename linear_probing_map<Key, Value>::slot* slots = nullptr;
+    std::size_t mask = 0;
+    std::size_t pos = 0;
+    Key key{};
+    const Value* found = nullptr;
+};
+
+/* Looks up all the keys in [first, last), keeping group of them in flight at once (asynchronous memory access chaining).
+ *
+ * Instead of waiting for the cache miss of one lookup, a lookup whose probe was just prefetched yields to the next one,
+ * and a finished lookup is immediately replaced by a new key. Results are visited in completion order, not in key order.
+ */
+template <typename Container, typename KeyIterator, typename Visitor>
+void interleaved_find(const Container& data, KeyIterator first, KeyIterator last, std::size_t group, Visitor visit){
+    std::array<lookup_cursor<Container>, max_lookup_group> cursors;
+    group = std::min(std::max<std::size_t>(group, 1), max_lookup_group);
+
+    std::size_t active = 0;
+    for (; active < group && first != last; ++active, ++first){
+        cursors[active].start(data, *first);
+    }
+
+    while (active > 0){
+        for (std::size_t i = 0; i < active; ){
+            if (!cursors[i].step()){
+                ++i;
+                continue;
+            }
+            visit(cursors[i].result());
+            if (first != last){
+                cursors[i].start(data, *first);
+                ++first;
+                ++i;
+            } else {
+                //Last unfinished lookup takes over the slot, and gets its step in this round.
+                cursors[i] = cursors[--active];
+            }
+        }
+    }
+}
+
+/* Plain lookups of a single key, returning the same pointers as lookup_cursor::result.
+ */
+template <typename T>
+const T* find_value(const std::vector<T>& data, const T& key){
+    auto it = std::lower_bound(begin(data), end(data), key);
+    return it != end(data) && *it == key ? &*it : nullptr;
+}
+
+template <typename Key, typename Value>
+const Value* find_value(const flatmap<Key, Value>& data, const Key& key){
+    auto it = data.find(key);
+    return it != data.end() ? &it->second : nullptr;
+}
+
+template <typename Key, typename Value>
+const Value* find_value(const linear_probing_map<Key, Value>& data, const Key& key){
+    return data.find(key);
+}
+
+#endif
@@ -2,7 +2,23 @@
 #ifndef WTF_BENCHMARKS
 #define WTF_BENCHMARKS
 
+#include <thread>
+#include <atomic>
+#include <chrono>
+#include <iostream>
+
 #include "polymorphic_bench.hpp"
+#include "access_modes.h"
+#include "key_distributions.h"
+#include "sorting.h"
+#include "aggregation.h"
+#include "amac.h"
+#include "tracing.h"
+#include "allocation_tracking.h"
+#include "file_access.h"
+#include "queues.h"
+#include "bloom_filter.h"
+#include "compressed_flatmap.h"
 
 constexpr std::size_t rep_count = 10;
 constexpr std::size_t smallest_sequence = 1 << 3;
@@ -11,13 +27,56 @@ constexpr std::size_t smallest_map = 1 << 3;
 constexpr std::size_t largest_map = 1 << 15; //Separate from sequence, because at 1 << 27, maps were untractable.
 constexpr std::size_t smallest_matrix = 1 << 1;
 constexpr std::size_t largest_matrix = 1 << 11;
+constexpr std::size_t matrix_padding = 8; //One cache line worth of doubles.
 constexpr std::size_t smallest_step = 1 << 0;
 constexpr std::size_t largest_step = 1 << 10;
 constexpr std::size_t smallest_poly_sequence = 1 << 8;
 constexpr std::size_t largest_poly_sequence = 1 << 24;
+constexpr std::size_t largest_insertion_sequence = 1 << 20; //Finding the middle of a list is linear, so this is kept lower.
+constexpr std::size_t middle_insertions = 16;
+constexpr std::size_t largest_sort = 1 << 24; //Sorting needs the input, a working copy and possibly a buffer.
+constexpr std::size_t aggregation_pairs = 1 << 23;
+constexpr std::size_t smallest_distinct = 1 << 4;
+constexpr std::size_t largest_distinct = 1 << 22; //Global table then has 8M slots, far past any LLC.
+constexpr std::size_t smallest_interleaved = 1 << 10;
+constexpr std::size_t largest_interleaved = 1 << 24; //128 MiB worth of int pairs, so the lookups miss even the LLC.
+constexpr std::size_t interleaved_lookup_count = 1 << 20;
+constexpr std::size_t smallest_compressed_map = 1 << 10;
+constexpr std::size_t largest_compressed_map = 1 << 24; //Even 8 bit deltas take 16 MiB of keys at this size, past a typical LLC.
+constexpr std::size_t smallest_file = 1 << 18; //In ints, so 1 MiB.
+constexpr std::size_t largest_file = 1 << 26; //256 MiB, still fits into page cache of any machine worth measuring on.
+constexpr std::size_t read_buffer_sizes[] = {4 * 1024, 64 * 1024, 1024 * 1024};
+constexpr std::size_t queue_capacity = 1024;
+constexpr std::size_t queue_messages = 1 << 20; //Per repetition, split evenly between producers.
+constexpr std::size_t queue_round_trips = 1 << 14;
+constexpr double latency_percentiles[] = {50, 90, 99, 99.9};
+constexpr std::size_t smallest_records = 1 << 3;
+constexpr std::size_t largest_records = 1 << 22; //8 floats per record, so this is already 128 MiB.
+constexpr std::size_t smallest_chase = 1 << 1;
+constexpr std::size_t largest_chase = 1 << 13;
+constexpr std::size_t chase_accesses = 1 << 20;
+//In ints. Mix of line multiples, primes and values just around powers of two.
+constexpr std::size_t chase_strides[] = {16, 17, 31, 64, 127, 256, 1008, 1024, 1040, 2048, 4093, 4096};
+constexpr std::size_t aliasing_elements = 1 << 10; //4 KiB worth of ints.
+constexpr std::size_t aliasing_passes = 1 << 6;
+constexpr std::size_t range_scan_length = 64;
+constexpr double zipf_exponent = 0.99;
+constexpr double hot_key_fraction = 0.05;
+constexpr double hot_key_probability = 0.95;
+constexpr std::size_t lookup_hit_percentages[] = {100, 90, 50, 10, 0};
+constexpr std::size_t concurrent_map_size = largest_map;
+constexpr std::size_t concurrent_lookup_batch = 64; //Readers check whether to stop only once per batch.
+constexpr std::chrono::milliseconds concurrent_duration(250);
+constexpr std::size_t concurrent_write_rates[] = {0, 10, 100, 1000, 10000}; //Writes per second.
 
 using measurements = std::vector<std::pair<int, std::uint64_t>>;
 
+/* Two dimensional measurements, each row is <row value, a value for each column>.
+ */
+template <typename Value>
+using basic_grid = std::vector<std::pair<int, std::vector<Value>>>;
+using measurement_grid = basic_grid<std::uint64_t>;
+
 /* Measures iteration+summation speed of list and vector.
  *
  * start_at is first converted to nearest, lower power of two and then it is clamped at 8
@@ -37,9 +96,12 @@ measurements measure_iteration(std::size_t start_at, std::size_t end_at){
     results.reserve(32);
 
     for (auto n = end_at; n >= start_at; n /= 2){
+        trace_phase phase("generate", n);
         auto data = generate_random_sequence(n);
+        phase.next("construct");
         Container test_data(begin(data), end(data));
-        auto time = bench([&](){return std::accumulate(begin(test_data), end(test_data), 0);}, rep_count).count();
+        phase.next("measure");
+        auto time = bench([&](){return std::accumulate(std::begin(test_data), std::end(test_data), 0);}, rep_count).count();
         results.emplace_back(n, time);
     }
 
@@ -66,8 +128,11 @@ measurements measure_reversed_iteration(std::size_t start_at, std::size_t end_at
     results.reserve(32);
 
     for (auto n = end_at; n >= start_at; n /= 2){
+        trace_phase phase("generate", n);
         auto data = generate_random_sequence(n);
+        phase.next("construct");
         Container test_data(begin(data), end(data));
+        phase.next("measure");
         auto time = bench([&](){return std::accumulate(test_data.rbegin(), test_data.rend(), 0u);}, rep_count).count();
         results.emplace_back(n, time);
     }
@@ -77,16 +142,56 @@ measurements measure_reversed_iteration(std::size_t start_at, std::size_t end_at
 }
 
 
+/* Measures inserting middle_insertions elements into the middle of a container, one by one.
+ *
+ * Middle is found by walking from the start, so this measures the cost of finding the position as well.
+ * start_at is first converted to nearest, lower power of two and then it is clamped at 8
+ * end_at is first converted to nearest, higher power of two and then it is clamped at 2**20.
+ *
+ *
+ * Returns range of <size, ns taken> values.
+ */
+template <typename Container>
+measurements measure_middle_insertion(std::size_t start_at, std::size_t end_at){
+    start_at = lower_power_of_2(std::max(start_at, smallest_sequence));
+    end_at = upper_power_of_2(std::min(end_at, largest_insertion_sequence));
+
+    measurements results;
+    results.reserve(32);
+
+    for (auto n = end_at; n >= start_at; n /= 2){
+        trace_phase phase("generate", n);
+        auto data = generate_random_sequence(n);
+        phase.next("construct");
+        Container test_data(begin(data), end(data));
+        phase.next("measure");
+        std::size_t size = n;
+        auto time = bench([&](){
+            for (std::size_t i = 0; i < middle_insertions; ++i){
+                test_data.insert(std::next(std::begin(test_data), size / 2), i);
+                ++size;
+            }
+            return size;
+        }, rep_count).count();
+        results.emplace_back(n, time);
+    }
+
+    std::reverse(begin(results), end(results));
+    return results;
+}
+
 /* Measures multiplication speed of matrices.
  *
  * start_at is first converted to nearest, lower power of two and then it is clamped at 2
  * end_at is first converted to nearest, higher power of two and then it is clamped at 2**11, so that the benchmarks end today.
+ * padding is the number of extra elements at the end of each row.
+ * T is the type of matrix elements.
  *
  *
  * Returns range of <size, ns taken> values.
  */
-template <typename MultiplyMethod>
-measurements measure_matrix_multiplication(std::size_t start_at, std::size_t end_at, MultiplyMethod method){
+template <typename T = double, typename MultiplyMethod>
+measurements measure_matrix_multiplication(std::size_t start_at, std::size_t end_at, MultiplyMethod method, std::size_t padding = 0){
     //clamp the results
     start_at = lower_power_of_2(std::max(start_at, smallest_matrix));
     end_at = upper_power_of_2(std::min(end_at, largest_matrix));
@@ -95,9 +200,11 @@ measurements measure_matrix_multiplication(std::size_t start_at, std::size_t end
     results.reserve(16);
 
     for (auto n = end_at; n >= start_at; n /= 2){
-        auto matrix1 = generate_matrix(n, n);
-        auto matrix2 = generate_matrix(n, n);
+        trace_phase phase("generate", n);
+        auto matrix1 = generate_matrix<T>(n, n, 0, padding);
+        auto matrix2 = generate_matrix<T>(n, n, 0, padding);
 
+        phase.next("measure");
         auto time = bench([&](){return method(matrix1, matrix2).columns();}, rep_count).count();
         results.emplace_back(n, time);
     }
@@ -107,10 +214,73 @@ measurements measure_matrix_multiplication(std::size_t start_at, std::size_t end
 
 }
 
+/* Measures transposition speed of matrices.
+ *
+ * Clamping is the same as for measure_matrix_multiplication.
+ *
+ *
+ * Returns range of <size, ns taken> values.
+ */
+template <typename TransposeMethod>
+measurements measure_matrix_transpose(std::size_t start_at, std::size_t end_at, TransposeMethod method, std::size_t padding = 0){
+    start_at = lower_power_of_2(std::max(start_at, smallest_matrix));
+    end_at = upper_power_of_2(std::min(end_at, largest_matrix));
+
+    measurements results;
+    results.reserve(16);
+
+    for (auto n = end_at; n >= start_at; n /= 2){
+        trace_phase phase("generate", n);
+        auto mat = generate_matrix(n, n, 0, padding);
+
+        phase.next("measure");
+        auto time = bench([&](){return method(mat).columns();}, rep_count).count();
+        results.emplace_back(n, time);
+    }
+
+    std::reverse(begin(results), end(results));
+    return results;
+}
+
+/* Measures sequential traversal of a vector, where every element is accessed according to Mode.
+ *
+ * Clamping is the same as for measure_iteration.
+ *
+ *
+ * Returns range of <size, ns taken> values.
+ */
+template <access_mode Mode>
+measurements measure_sequential_access(std::size_t start_at, std::size_t end_at){
+    start_at = lower_power_of_2(std::max(start_at, smallest_sequence));
+    end_at = upper_power_of_2(std::min(end_at, largest_sequence));
+
+    measurements results;
+    results.reserve(32);
+
+    for (auto n = end_at; n >= start_at; n /= 2){
+        trace_phase phase("generate", n);
+        auto data = generate_random_sequence(n);
+        phase.next("measure");
+        auto time = bench([&](){
+            uint32_t temp = 0;
+            for (std::size_t i = 0; i < n; ++i){
+                element_access<Mode>::apply(data[i], i, temp);
+            }
+            element_access<Mode>::finish();
+            return temp;
+        }, rep_count).count();
+        results.emplace_back(n, time);
+    }
+
+    std::reverse(begin(results), end(results));
+    return results;
+}
+
 /* First attempt at implementing skipping iteration.
  *
- * Might need to be changed to dirty cache lines before final benchmarking.
+ * Mode selects whether the visited elements are only read, or the cache lines are also dirtied.
  */
+template <access_mode Mode = access_mode::read>
 measurements measure_vector_skip(std::size_t first_step, std::size_t last_step){
     first_step = lower_power_of_2(std::max(first_step, smallest_step));
     last_step = upper_power_of_2(std::min(last_step, largest_step));
@@ -119,12 +289,15 @@ measurements measure_vector_skip(std::size_t first_step, std::size_t last_step){
     results.reserve(32);
 
     for (auto step_size = first_step; step_size <= last_step; step_size *= 2){
+        trace_phase phase("generate", step_size);
         auto data = generate_random_sequence(largest_sequence);
+        phase.next("measure");
         auto time = bench([&](){
             uint32_t result = 0;
             for (std::size_t i = 0; i < largest_sequence; i += step_size){
-                result += data[i];
+                element_access<Mode>::apply(data[i], i, result);
             }
+            element_access<Mode>::finish();
             return result;
         }, rep_count).count();
         results.emplace_back(step_size, time);
@@ -135,7 +308,9 @@ measurements measure_vector_skip(std::size_t first_step, std::size_t last_step){
 /* A first attempt at implementing random iteration.
  *
  * Hopefully the LCG-based RNG isn't too complicated to skew the results too much.
+ * Mode selects whether the visited elements are only read, or the cache lines are also dirtied.
  */
+template <access_mode Mode = access_mode::read>
 measurements measure_random_iteration(std::size_t start_at, std::size_t end_at){
     start_at = lower_power_of_2(std::max(start_at, smallest_sequence));
     end_at = upper_power_of_2(std::min(end_at, largest_sequence));
@@ -145,13 +320,16 @@ measurements measure_random_iteration(std::size_t start_at, std::size_t end_at){
     results.reserve(32);
 
     for (auto n = end_at; n >= start_at; n /= 2){
+        trace_phase phase("generate", n);
         auto data = generate_random_sequence(n);
         auto mask = n - 1;
+        phase.next("measure");
         auto time = bench([&](){
             uint32_t temp = 0;
             for (std::size_t i = 0; i < n; ++i){
-                temp += data[RNG.get_next() & mask];
+                element_access<Mode>::apply(data[RNG.get_next() & mask], i, temp);
             }
+            element_access<Mode>::finish();
             return temp;
         }, rep_count).count();
         results.emplace_back(n, time);
@@ -161,16 +339,128 @@ measurements measure_random_iteration(std::size_t start_at, std::size_t end_at){
     return results;
 }
 
+/* Puts measurements taken over the same sizes next to each other, as columns of a grid.
+ */
+measurement_grid merge_columns(const std::vector<measurements>& columns){
+    measurement_grid results;
+    if (columns.empty()){
+        return results;
+    }
+
+    for (std::size_t i = 0; i < columns.front().size(); ++i){
+        std::vector<std::uint64_t> row;
+        for (const auto& column : columns){
+            row.push_back(column[i].second);
+        }
+        results.emplace_back(columns.front()[i].first, std::move(row));
+    }
+    return results;
+}
+
+/* Measures effective cache capacity at different strides.
+ *
+ * For every stride in chase_strides (in ints), builds a pointer chase through given number of lines,
+ * placed stride apart and visited in random order, and follows it for chase_accesses steps.
+ * When all the lines would fit into cache, but they map into too few sets, the time jumps earlier than capacity alone would suggest.
+ *
+ * first_lines is first converted to nearest, lower power of two and then it is clamped at 2
+ * last_lines is first converted to nearest, higher power of two and then it is clamped at 2**13.
+ *
+ *
+ * Returns grid of <stride, ns taken for each line count> values.
+ */
+measurement_grid measure_stride_capacity(std::size_t first_lines, std::size_t last_lines){
+    first_lines = lower_power_of_2(std::max(first_lines, smallest_chase));
+    last_lines = upper_power_of_2(std::min(last_lines, largest_chase));
+
+    measurement_grid results;
+    std::mt19937_64 rand(0);
+
+    for (auto stride : chase_strides){
+        std::vector<std::uint64_t> row;
+        for (auto lines = first_lines; lines <= last_lines; lines *= 2){
+            trace_phase phase("generate", lines);
+            std::vector<std::uint32_t> order(lines);
+            std::iota(begin(order), end(order), 0);
+            std::shuffle(begin(order), end(order), rand);
+
+            std::vector<std::uint32_t> data(lines * stride);
+            for (std::size_t i = 0; i < lines; ++i){
+                data[order[i] * stride] = order[(i + 1) % lines] * stride;
+            }
+
+            phase.next("measure");
+            auto time = bench([&](){
+                std::uint32_t pos = order[0] * stride;
+                for (std::size_t i = 0; i < chase_accesses; ++i){
+                    pos = data[pos];
+                }
+                return pos;
+            }, rep_count).count();
+            row.push_back(time);
+        }
+        results.emplace_back(stride, std::move(row));
+    }
+
+    return results;
+}
+
+/* Measures 4K aliasing between stores and following loads.
+ *
+ * Copies aliasing_elements ints from source to destination, that starts 4 KiB + offset bytes after the source.
+ * Loads whose address matches an earlier, still pending store in the lowest 12 bits are falsely considered
+ * dependent on it, so small positive offsets should be slower.
+ *
+ * Both offsets are in bytes, rounded down to whole ints and clamped at 4096.
+ *
+ *
+ * Returns range of <offset, ns taken> values.
+ */
+measurements measure_4k_aliasing(std::size_t first_offset, std::size_t last_offset, std::size_t offset_step){
+    first_offset = std::min(first_offset, aliasing_elements * sizeof(int)) / sizeof(int);
+    last_offset = std::min(last_offset, aliasing_elements * sizeof(int)) / sizeof(int);
+    offset_step = std::max(offset_step / sizeof(int), std::size_t(1));
+
+    std::vector<int, aligned_allocator<int, 4096>> buffer(3 * aliasing_elements, 1);
+    measurements results;
+    results.reserve(256);
+
+    for (auto offset = first_offset; offset <= last_offset; offset += offset_step){
+        trace_phase phase("measure", offset * sizeof(int));
+        const int* src = buffer.data();
+        int* dst = buffer.data() + aliasing_elements + offset;
+        auto time = bench([&](){
+            for (std::size_t pass = 0; pass < aliasing_passes; ++pass){
+                for (std::size_t i = 0; i < aliasing_elements; ++i){
+                    dst[i] = src[i] + 1;
+                }
+            }
+            return dst[0];
+        }, rep_count).count();
+        results.emplace_back(offset * sizeof(int), time);
+    }
+
+    return results;
+}
+
 #include <array>
 
-struct BFPOD {
-    std::array<uint8_t, 4096> stuffing = {};
+/* Map value of given size, without any behaviour.
+ */
+template <std::size_t Size>
+struct payload {
+    std::array<uint8_t, Size> stuffing = {};
 };
 
+using BFPOD = payload<4096>;
+
 /* Random reads, writes.
+ *
+ * If space is given, allocations done to construct the container and within the measured region are added to it.
  */
 template <typename Container, std::size_t N_reads, std::size_t N_writes>
-measurements measure_random_access(std::size_t start_at, std::size_t end_at){
+measurements measure_random_access(std::size_t start_at, std::size_t end_at, footprints* space = nullptr){
+    using mapped_type = typename Container::mapped_type;
     static constexpr auto N_total = N_reads + N_writes;
     static_assert(is_power_of_2(N_total), "N_reads + N_writes must be a power of two.");
     start_at = lower_power_of_2(std::max(start_at, std::max(smallest_sequence, N_total)));
@@ -181,16 +471,22 @@ measurements measure_random_access(std::size_t start_at, std::size_t end_at){
     results.reserve(32);
 
     for (auto n = end_at; n >= start_at; n /= 2){
+        trace_phase phase("generate", n);
         auto read_size = n / N_total * N_reads;
         auto numbers_start = wtf::counting_iterator<int>(1, 2);
         auto numbers_end = numbers_start + read_size;
         auto write_iter = wtf::counting_iterator<int>(0, 2);
         std::vector<int> nums(numbers_start, numbers_end);
+        phase.next("construct");
+        allocation_scope setup;
         Container data;
-        std::transform(begin(nums), end(nums), std::inserter(data, data.end()), [](int i){ return std::pair<const int, BFPOD>(i, BFPOD{});});
+        std::transform(begin(nums), end(nums), std::inserter(data, data.end()), [](int i){ return std::pair<const int, mapped_type>(i, mapped_type{});});
+        auto setup_stats = setup.stats();
         auto mask = read_size - 1;
+        phase.next("measure");
 
-        auto time = bench([=, &RNG, &data, &write_iter](){
+        allocation_scope timed;
+        auto time = bench([&](){
             uint32_t temp = 0;
 
             for (std::size_t i = 0; i < n; i += N_total){
@@ -199,7 +495,7 @@ measurements measure_random_access(std::size_t start_at, std::size_t end_at){
                 }
 
                 for (std::size_t j = 0; j < N_writes; ++j) {
-                    data.insert(std::make_pair(*write_iter ,BFPOD{}));
+                    data.insert(std::make_pair(*write_iter, mapped_type{}));
                     ++write_iter;
                 }
             }
@@ -208,9 +504,109 @@ measurements measure_random_access(std::size_t start_at, std::size_t end_at){
         }, rep_count).count();
 
         results.emplace_back(n, time);
+        if (space){
+            space->emplace_back(n, footprint{read_size, setup_stats, timed.stats()});
+        }
     }
 
     std::reverse(begin(results), end(results));
+    if (space){
+        std::reverse(begin(*space), end(*space));
+    }
+    return results;
+}
+
+/* Measures aggregate lookup throughput of a map shared by many reader threads and a single, rate limited writer.
+ *
+ * Reader count goes from 1 to max_readers, doubling each time, writer inserts keys that are never read
+ * at each rate from concurrent_write_rates. Every combination runs for concurrent_duration.
+ *
+ *
+ * Returns grid of <reader threads, lookups per second for each write rate> values.
+ */
+template <typename ConcurrentMap>
+measurement_grid measure_concurrent_reads(std::size_t max_readers){
+    using value_type = typename ConcurrentMap::value_type;
+    using clock = std::chrono::steady_clock;
+
+    const auto n = concurrent_map_size;
+    const auto mask = n - 1;
+    trace_phase phase("generate", n);
+    auto numbers_start = wtf::counting_iterator<int>(1, 2);
+    std::vector<int> nums(numbers_start, numbers_start + n);
+    std::vector<std::pair<int, int>> elements;
+    std::transform(begin(nums), end(nums), std::back_inserter(elements), [](int i){ return std::make_pair(i, i); });
+
+    phase.end();
+    measurement_grid results;
+
+    for (std::size_t readers = 1; readers <= max_readers; readers *= 2){
+        std::vector<std::uint64_t> row;
+        for (auto rate : concurrent_write_rates){
+            auto max_writes = rate * concurrent_duration.count() / 1000;
+            trace_phase rate_phase("construct", readers);
+            ConcurrentMap data(begin(elements), end(elements), n + max_writes);
+            rate_phase.next("measure");
+
+            std::atomic<bool> start{false}, stop{false};
+            std::vector<std::uint64_t> lookups(readers);
+            std::vector<std::uint32_t> checksums(readers);
+            std::vector<std::thread> threads;
+
+            for (std::size_t t = 0; t < readers; ++t){
+                threads.emplace_back([&, t](){
+                    unpin_current_thread();
+                    typename ConcurrentMap::reader handle(data);
+                    LCG RNG(t + 1);
+                    std::uint64_t done = 0;
+                    int last = 0;
+                    std::uint32_t temp = 0;
+                    while (!start.load(std::memory_order_acquire)){}
+                    while (!stop.load(std::memory_order_relaxed)){
+                        for (std::size_t i = 0; i < concurrent_lookup_batch; ++i){
+                            handle.find(nums[RNG.get_next() & mask], [&](const value_type& el){ last = el.first; });
+                            temp += last;
+                        }
+                        done += concurrent_lookup_batch;
+                    }
+                    lookups[t] = done;
+                    checksums[t] = temp;
+                });
+            }
+
+            if (rate != 0){
+                threads.emplace_back([&](){
+                    unpin_current_thread();
+                    const auto interval = std::chrono::duration_cast<clock::duration>(std::chrono::seconds(1)) / rate;
+                    auto write_iter = wtf::counting_iterator<int>(0, 2);
+                    auto next = clock::now();
+                    while (!start.load(std::memory_order_acquire)){}
+                    for (std::size_t i = 0; i < max_writes && !stop.load(std::memory_order_relaxed); ++i){
+                        next += interval;
+                        std::this_thread::sleep_until(next);
+                        data.insert(value_type(*write_iter, *write_iter));
+                        ++write_iter;
+                    }
+                });
+            }
+
+            auto t1 = clock::now();
+            start.store(true, std::memory_order_release);
+            std::this_thread::sleep_for(concurrent_duration);
+            stop.store(true, std::memory_order_relaxed);
+            auto t2 = clock::now();
+            for (auto& thread : threads){
+                thread.join();
+            }
+
+            static volatile std::uint32_t c = 0;
+            c = c + std::accumulate(begin(checksums), end(checksums), std::uint32_t(0));
+            auto total = std::accumulate(begin(lookups), end(lookups), std::uint64_t(0));
+            row.push_back(total * 1000000000 / std::chrono::duration_cast<std::chrono::nanoseconds>(t2 - t1).count());
+        }
+        results.emplace_back(readers, std::move(row));
+    }
+
     return results;
 }
 
@@ -223,7 +619,9 @@ measurements measure_polymorphic_container(std::size_t start_at, std::size_t end
     results.reserve(32);
 
     for (auto n = end_at; n >= start_at; n /= 2){
+        trace_phase phase("construct", n);
         auto data = fill<Container>(n);
+        phase.next("measure");
         auto time = bench([&](){
             std::uint32_t temp = 0;
             data.for_each([&](const base& el){ temp += el.foo(1);});
@@ -238,8 +636,13 @@ measurements measure_polymorphic_container(std::size_t start_at, std::size_t end
 }
 
 
+/* Inserts as many new keys into a map as it already holds.
+ *
+ * If space is given, allocations done to construct the container and within the measured region are added to it.
+ */
 template <typename Container>
-measurements measure_write(){
+measurements measure_write(footprints* space = nullptr){
+    using mapped_type = typename Container::mapped_type;
     auto start_at = smallest_map;
     auto end_at = largest_map;
 
@@ -247,18 +650,23 @@ measurements measure_write(){
     results.reserve(32);
 
     for (auto n = end_at; n >= start_at; n /= 2){
+        trace_phase phase("construct", n);
         auto numbers_start = wtf::counting_iterator<int>(1, 2);
         auto numbers_end = numbers_start + n;
 
         auto write_iter = wtf::counting_iterator<int>(0, 2);
+        allocation_scope setup;
         Container data;
-        std::transform(numbers_start, numbers_end, std::inserter(data, data.end()), [](int i){ return std::pair<const int, BFPOD>(i, BFPOD{});});
+        std::transform(numbers_start, numbers_end, std::inserter(data, data.end()), [](int i){ return std::pair<const int, mapped_type>(i, mapped_type{});});
+        auto setup_stats = setup.stats();
+        phase.next("measure");
 
+        allocation_scope timed;
         auto time = bench([=, &data, &write_iter](){
             uint32_t temp = 0;
 
             for (std::size_t i = 0; i < n; ++i){
-                if (data.insert(std::make_pair(*write_iter ,BFPOD{})).second) {
+                if (data.insert(std::make_pair(*write_iter, mapped_type{})).second) {
                     write_iter++;
                     temp++;
                 }
@@ -267,6 +675,155 @@ measurements measure_write(){
             return temp;
         }, rep_count).count();
 
+        results.emplace_back(n, time);
+        if (space){
+            space->emplace_back(n, footprint{n, setup_stats, timed.stats()});
+        }
+    }
+
+    std::reverse(begin(results), end(results));
+    if (space){
+        std::reverse(begin(*space), end(*space));
+    }
+    return results;
+}
+
+/* Measures updating the first Fields fields of every record, stored in a given Layout.
+ *
+ * start_at is first converted to nearest, lower power of two and then it is clamped at 8
+ * end_at is first converted to nearest, higher power of two and then it is clamped at 2**22.
+ *
+ *
+ * Returns range of <size, ns taken> values.
+ */
+template <typename Layout, std::size_t Fields>
+measurements measure_layout_update(std::size_t start_at, std::size_t end_at){
+    static_assert(Fields <= record_fields, "Cannot update more fields than a record has.");
+    start_at = lower_power_of_2(std::max(start_at, smallest_records));
+    end_at = upper_power_of_2(std::min(end_at, largest_records));
+
+    measurements results;
+    results.reserve(32);
+
+    for (auto n = end_at; n >= start_at; n /= 2){
+        trace_phase phase("construct", n);
+        Layout data(n);
+        phase.next("measure");
+        auto time = bench([&](){return static_cast<int>(data.template update<Fields>());}, rep_count).count();
+        results.emplace_back(n, time);
+    }
+
+    std::reverse(begin(results), end(results));
+    return results;
+}
+
+/* Runs measure_random_access for maps holding payloads of each of the given Sizes.
+ *
+ * MapOf maps value type to the map type to be measured.
+ *
+ *
+ * Returns grid of <size, ns taken for each payload size> values.
+ */
+template <template <typename> class MapOf, std::size_t N_reads, std::size_t N_writes, std::size_t... Sizes>
+measurement_grid measure_random_access_payloads(std::size_t start_at, std::size_t end_at){
+    return merge_columns({measure_random_access<MapOf<payload<Sizes>>, N_reads, N_writes>(start_at, end_at)...});
+}
+
+/* Runs measure_write for maps holding payloads of each of the given Sizes.
+ *
+ *
+ * Returns grid of <size, ns taken for each payload size> values.
+ */
+template <template <typename> class MapOf, std::size_t... Sizes>
+measurement_grid measure_write_payloads(){
+    return merge_columns({measure_write<MapOf<payload<Sizes>>>()...});
+}
+
+/* Random range scans, each starting at a random existing key and visiting next range_scan_length elements.
+ *
+ * Every run visits roughly as many elements as the container holds.
+ *
+ *
+ * Returns range of <size, ns taken> values.
+ */
+template <typename Container>
+measurements measure_range_scan(std::size_t start_at, std::size_t end_at){
+    using mapped_type = typename Container::mapped_type;
+    start_at = lower_power_of_2(std::max(start_at, std::max(smallest_map, range_scan_length)));
+    end_at = upper_power_of_2(std::min(end_at, largest_map));
+
+    LCG RNG;
+    measurements results;
+    results.reserve(32);
+
+    for (auto n = end_at; n >= start_at; n /= 2){
+        trace_phase phase("generate", n);
+        auto numbers_start = wtf::counting_iterator<int>(1, 2);
+        std::vector<int> nums(numbers_start, numbers_start + n);
+        phase.next("construct");
+        Container data;
+        std::transform(begin(nums), end(nums), std::inserter(data, data.end()), [](int i){ return std::pair<const int, mapped_type>(i, mapped_type{});});
+        auto mask = n - 1;
+
+        phase.next("measure");
+        auto time = bench([&](){
+            uint32_t temp = 0;
+            for (std::size_t i = 0; i < n; i += range_scan_length){
+                auto it = data.lower_bound(nums[RNG.get_next() & mask]);
+                for (std::size_t j = 0; j < range_scan_length && it != data.end(); ++j, ++it){
+                    temp += it->first;
+                }
+            }
+            return temp;
+        }, rep_count).count();
+
+        results.emplace_back(n, time);
+    }
+
+    std::reverse(begin(results), end(results));
+    return results;
+}
+
+/* Random reads, with keys picked according to KeyDistribution, constructed from the map size and params.
+ *
+ * Keys are drawn before the measured region, so the cost of sampling a skewed distribution does not show in the results.
+ *
+ *
+ * Returns range of <size, ns taken> values.
+ */
+template <typename Container, typename KeyDistribution, typename... Params>
+measurements measure_skewed_reads(std::size_t start_at, std::size_t end_at, Params... params){
+    using mapped_type = typename Container::mapped_type;
+    start_at = lower_power_of_2(std::max(start_at, smallest_map));
+    end_at = upper_power_of_2(std::min(end_at, largest_map));
+
+    std::mt19937_64 rand(0);
+    measurements results;
+    results.reserve(32);
+
+    for (auto n = end_at; n >= start_at; n /= 2){
+        trace_phase phase("generate", n);
+        auto numbers_start = wtf::counting_iterator<int>(1, 2);
+        std::vector<int> nums(numbers_start, numbers_start + n);
+        phase.next("construct");
+        Container data;
+        std::transform(begin(nums), end(nums), std::inserter(data, data.end()), [](int i){ return std::pair<const int, mapped_type>(i, mapped_type{});});
+
+        phase.next("generate");
+        KeyDistribution dist(n, params...);
+        std::vector<int> keys;
+        keys.reserve(n);
+        std::generate_n(std::back_inserter(keys), n, [&](){ return nums[dist(rand)]; });
+        phase.next("measure");
+
+        auto time = bench([&](){
+            uint32_t temp = 0;
+            for (auto key : keys){
+                temp += data.find(key)->first;
+            }
+            return temp;
+        }, rep_count).count();
+
         results.emplace_back(n, time);
     }
 
@@ -274,4 +831,669 @@ measurements measure_write(){
     return results;
 }
 
+/* Runs measure_skewed_reads with uniform, Zipf and hot set/cold set key distributions.
+ *
+ *
+ * Returns grid of <size, ns taken for each distribution> values.
+ */
+template <typename Container>
+measurement_grid measure_key_distributions(std::size_t start_at, std::size_t end_at){
+    return merge_columns({
+        measure_skewed_reads<Container, uniform_keys>(start_at, end_at),
+        measure_skewed_reads<Container, zipf_keys>(start_at, end_at, zipf_exponent),
+        measure_skewed_reads<Container, hot_set_keys>(start_at, end_at, hot_key_fraction, hot_key_probability)
+    });
+}
+
+/* Measures random lookups where only hit_percent of the looked up keys are present in the Container.
+ *
+ * Inserted keys are odd, so the misses use the even keys right below them, which are never inserted.
+ * Keys are drawn before the measured region, same as in measure_skewed_reads.
+ *
+ *
+ * Returns range of <size, ns taken> values.
+ */
+template <typename Container>
+measurements measure_lookup_misses(std::size_t start_at, std::size_t end_at, std::size_t hit_percent){
+    using mapped_type = typename Container::mapped_type;
+    start_at = lower_power_of_2(std::max(start_at, smallest_map));
+    end_at = upper_power_of_2(std::min(end_at, largest_map));
+
+    LCG RNG;
+    measurements results;
+    results.reserve(32);
+
+    for (auto n = end_at; n >= start_at; n /= 2){
+        trace_phase phase("generate", n);
+        auto numbers_start = wtf::counting_iterator<int>(1, 2);
+        std::vector<int> nums(numbers_start, numbers_start + n);
+        std::vector<int> keys;
+        keys.reserve(n);
+        std::generate_n(std::back_inserter(keys), n, [&](){
+            auto key = nums[RNG.get_next() & (n - 1)];
+            return RNG.get_next() % 100 < hit_percent ? key : key - 1;
+        });
+        phase.next("construct");
+        Container data;
+        std::transform(begin(nums), end(nums), std::inserter(data, data.end()), [](int i){ return std::pair<const int, mapped_type>(i, mapped_type{});});
+        phase.next("measure");
+
+        auto time = bench([&](){
+            uint32_t temp = 0;
+            for (auto key : keys){
+                auto it = data.find(key);
+                if (it != data.end()){
+                    temp += it->first;
+                }
+            }
+            return temp;
+        }, rep_count).count();
+
+        results.emplace_back(n, time);
+    }
+
+    std::reverse(begin(results), end(results));
+    return results;
+}
+
+/* Runs measure_lookup_misses for each of lookup_hit_percentages.
+ *
+ *
+ * Returns grid of <size, ns taken for each hit percentage> values.
+ */
+template <typename Container>
+measurement_grid measure_hit_ratios(std::size_t start_at, std::size_t end_at){
+    std::vector<measurements> columns;
+    for (auto hit_percent : lookup_hit_percentages){
+        columns.push_back(measure_lookup_misses<Container>(start_at, end_at, hit_percent));
+    }
+    return merge_columns(columns);
+}
+
+enum class sort_input {
+    random,
+    presorted,
+    reversed,
+    few_unique
+};
+
+template <typename Key>
+std::vector<Key> generate_sort_input(std::size_t size, sort_input kind){
+    if (kind == sort_input::few_unique){
+        auto data = generate_random_sequence(size);
+        return std::vector<Key>(begin(data), end(data));
+    }
+    auto data = generate_random_keys<Key>(size);
+    if (kind == sort_input::presorted){
+        std::sort(begin(data), end(data));
+    } else if (kind == sort_input::reversed){
+        std::sort(begin(data), end(data), [](Key lhs, Key rhs){ return rhs < lhs; });
+    }
+    return data;
+}
+
+/* Measures sorting speed of Sorter, on Key-typed input of given kind.
+ *
+ * Only the sorting itself is measured, copying the unsorted input back before each repetition is not.
+ * start_at is first converted to nearest, lower power of two and then it is clamped at 8
+ * end_at is first converted to nearest, higher power of two and then it is clamped at 2**24.
+ *
+ *
+ * Returns range of <size, ns taken> values.
+ */
+template <typename Key, typename Sorter>
+measurements measure_sort(std::size_t start_at, std::size_t end_at, sort_input kind){
+    start_at = lower_power_of_2(std::max(start_at, smallest_sequence));
+    end_at = upper_power_of_2(std::min(end_at, largest_sort));
+
+    Sorter sorter;
+    measurements results;
+    results.reserve(32);
+
+    for (auto n = end_at; n >= start_at; n /= 2){
+        trace_phase phase("generate", n);
+        auto data = generate_sort_input<Key>(n, kind);
+        std::vector<Key> work(n);
+        phase.next("measure");
+        auto time = bench_with_setup([&](){ std::copy(begin(data), end(data), begin(work)); },
+                                     [&](){ sorter(begin(work), end(work)); return static_cast<int>(work[0]); }, rep_count).count();
+        results.emplace_back(n, time);
+    }
+
+    std::reverse(begin(results), end(results));
+    return results;
+}
+
+/* Runs measure_sort for std::sort, std::stable_sort, LSD radix sort and blocked merge sort.
+ *
+ *
+ * Returns grid of <size, ns taken per element for each sorter> values.
+ */
+template <typename Key>
+basic_grid<double> measure_sorters(std::size_t start_at, std::size_t end_at, sort_input kind){
+    auto totals = merge_columns({
+        measure_sort<Key, std_sorter>(start_at, end_at, kind),
+        measure_sort<Key, stable_sorter>(start_at, end_at, kind),
+        measure_sort<Key, radix_sorter>(start_at, end_at, kind),
+        measure_sort<Key, blocked_merge_sorter>(start_at, end_at, kind)
+    });
+
+    basic_grid<double> results;
+    for (const auto& row : totals){
+        std::vector<double> per_element;
+        for (auto time : row.second){
+            per_element.push_back(static_cast<double>(time) / (row.first * rep_count));
+        }
+        results.emplace_back(row.first, std::move(per_element));
+    }
+    return results;
+}
+
+/* Measures group-by sum over aggregation_pairs pairs, with a single global hash table and with radix partitioning first.
+ *
+ * Keys are scrambled pair indices, so every one of the distinct keys appears equally often.
+ * Both aggregators allocate their tables and buffers before the measurement and only clear them in it.
+ * first_distinct is first converted to nearest, lower power of two and then it is clamped at 16
+ * last_distinct is first converted to nearest, higher power of two and then it is clamped at 2**22.
+ *
+ *
+ * Returns grid of <distinct keys, ns taken for global and partitioned aggregation> values.
+ */
+measurement_grid measure_aggregation(std::size_t first_distinct, std::size_t last_distinct){
+    first_distinct = lower_power_of_2(std::max(first_distinct, smallest_distinct));
+    last_distinct = upper_power_of_2(std::min(last_distinct, largest_distinct));
+
+    generate_random_pairs pairs(aggregation_pairs);
+    measurement_grid results;
+    aggregation_input input;
+    input.reserve(aggregation_pairs);
+
+    for (auto distinct = last_distinct; distinct >= first_distinct; distinct /= 2){
+        trace_phase phase("generate", distinct);
+        input.clear();
+        for (auto& pair : pairs){
+            const auto key = (static_cast<std::uint32_t>(pair.first) * 2654435761u) & (distinct - 1);
+            input.emplace_back(key, static_cast<std::uint32_t>(pair.second));
+        }
+
+        phase.next("construct");
+        global_aggregator global_table(distinct);
+        partitioned_aggregator partitioned(aggregation_pairs, distinct);
+
+        phase.next("measure");
+        auto global = bench([&](){ return static_cast<int>(global_table(input)); }, rep_count).count();
+        auto radix = bench([&](){ return static_cast<int>(partitioned(input)); }, rep_count).count();
+        results.emplace_back(distinct, std::vector<std::uint64_t>{static_cast<std::uint64_t>(global), static_cast<std::uint64_t>(radix)});
+    }
+
+    std::reverse(begin(results), end(results));
+    return results;
+}
+
+/* Builds a container for measure_interleaved_lookups, holding given keys, each mapped to itself.
+ */
+template <typename Container>
+Container build_lookup_target(const std::vector<int>& keys);
+
+template <>
+std::vector<int> build_lookup_target<std::vector<int>>(const std::vector<int>& keys){
+    return keys;
+}
+
+template <>
+flatmap<int, int> build_lookup_target<flatmap<int, int>>(const std::vector<int>& keys){
+    std::vector<std::pair<int, int>> elements;
+    std::transform(begin(keys), end(keys), std::back_inserter(elements), [](int i){ return std::make_pair(i, i); });
+    return flatmap<int, int>(begin(elements), end(elements));
+}
+
+template <>
+linear_probing_map<int, int> build_lookup_target<linear_probing_map<int, int>>(const std::vector<int>& keys){
+    linear_probing_map<int, int> table(keys.size());
+    for (auto key : keys){
+        table[key] = key;
+    }
+    return table;
+}
+
+template <>
+compressed_flatmap<int, int, std::uint8_t> build_lookup_target<compressed_flatmap<int, int, std::uint8_t>>(const std::vector<int>& keys){
+    std::vector<std::pair<int, int>> elements;
+    std::transform(begin(keys), end(keys), std::back_inserter(elements), [](int i){ return std::make_pair(i, i); });
+    return compressed_flatmap<int, int, std::uint8_t>(begin(elements), end(elements));
+}
+
+template <>
+compressed_flatmap<int, int, std::uint16_t> build_lookup_target<compressed_flatmap<int, int, std::uint16_t>>(const std::vector<int>& keys){
+    std::vector<std::pair<int, int>> elements;
+    std::transform(begin(keys), end(keys), std::back_inserter(elements), [](int i){ return std::make_pair(i, i); });
+    return compressed_flatmap<int, int, std::uint16_t>(begin(elements), end(elements));
+}
+
+/* Measures interleaved_lookup_count random lookups of existing keys, one by one and interleaved in groups.
+ *
+ * start_at is first converted to nearest, lower power of two and then it is clamped at 2**10
+ * end_at is first converted to nearest, higher power of two and then it is clamped at 2**24.
+ *
+ *
+ * Returns grid of <size, ns taken for sequential lookups and for each group size from 1 to max_lookup_group> values.
+ */
+template <typename Container>
+measurement_grid measure_interleaved_lookups(std::size_t start_at, std::size_t end_at){
+    start_at = lower_power_of_2(std::max(start_at, smallest_interleaved));
+    end_at = upper_power_of_2(std::min(end_at, largest_interleaved));
+
+    LCG RNG;
+    measurement_grid results;
+
+    for (auto n = end_at; n >= start_at; n /= 2){
+        trace_phase phase("generate", n);
+        auto numbers_start = wtf::counting_iterator<int>(1, 2);
+        std::vector<int> nums(numbers_start, numbers_start + n);
+        std::vector<int> keys;
+        keys.reserve(interleaved_lookup_count);
+        std::generate_n(std::back_inserter(keys), interleaved_lookup_count, [&](){ return nums[RNG.get_next() & (n - 1)]; });
+        phase.next("construct");
+        auto data = build_lookup_target<Container>(nums);
+
+        phase.next("measure");
+        std::vector<std::uint64_t> row;
+        row.push_back(bench([&](){
+            int temp = 0;
+            for (auto key : keys){
+                temp += *find_value(data, key);
+            }
+            return temp;
+        }, rep_count).count());
+        for (std::size_t group = 1; group <= max_lookup_group; group *= 2){
+            row.push_back(bench([&](){
+                int temp = 0;
+                interleaved_find(data, begin(keys), end(keys), group, [&](const int* value){ temp += *value; });
+                return temp;
+            }, rep_count).count());
+        }
+        results.emplace_back(n, std::move(row));
+    }
+
+    std::reverse(begin(results), end(results));
+    return results;
+}
+
+/* Measures interleaved_lookup_count random lookups of existing keys, one at a time, and records space taken by the Container.
+ *
+ * Setup allocations include the input the Container is built from, but only what the Container keeps is retained.
+ * start_at is first converted to nearest, lower power of two and then it is clamped at 2**10
+ * end_at is first converted to nearest, higher power of two and then it is clamped at 2**24.
+ *
+ *
+ * Returns range of <size, ns taken> values.
+ */
+template <typename Container>
+measurements measure_compressed_lookups(std::size_t start_at, std::size_t end_at, footprints& space){
+    start_at = lower_power_of_2(std::max(start_at, smallest_compressed_map));
+    end_at = upper_power_of_2(std::min(end_at, largest_compressed_map));
+
+    LCG RNG;
+    measurements results;
+    results.reserve(32);
+
+    for (auto n = end_at; n >= start_at; n /= 2){
+        trace_phase phase("generate", n);
+        auto numbers_start = wtf::counting_iterator<int>(1, 2);
+        std::vector<int> nums(numbers_start, numbers_start + n);
+        std::vector<int> keys;
+        keys.reserve(interleaved_lookup_count);
+        std::generate_n(std::back_inserter(keys), interleaved_lookup_count, [&](){ return nums[RNG.get_next() & (n - 1)]; });
+        phase.next("construct");
+        allocation_scope setup;
+        auto data = build_lookup_target<Container>(nums);
+        auto setup_stats = setup.stats();
+
+        phase.next("measure");
+        allocation_scope timed;
+        auto time = bench([&](){
+            int temp = 0;
+            for (auto key : keys){
+                temp += *find_value(data, key);
+            }
+            return temp;
+        }, rep_count).count();
+
+        results.emplace_back(n, time);
+        space.emplace_back(n, footprint{n, setup_stats, timed.stats()});
+    }
+
+    std::reverse(begin(results), end(results));
+    std::reverse(begin(space), end(space));
+    return results;
+}
+
+enum class file_order {
+    sequential,
+    random //Page by page, in shuffled order.
+};
+
+/* Measures summing an int array stored in a temporary file, through mmap with different hints and through pread.
+ *
+ * Sequential order has columns for mmap with MADV_NORMAL, page_advice::sequential, MADV_WILLNEED and MAP_POPULATE,
+ * then pread with each of read_buffer_sizes. Random order has columns for mmap with MADV_NORMAL, MADV_RANDOM
+ * and MAP_POPULATE, then pread of single pages.
+ * If cold is set, the file is evicted from the page cache before each repetition, otherwise it is read once before measuring.
+ * Eviction needs TMPDIR on a filesystem backed by a block device, if the file stays resident the cold columns are
+ * reported as 0 instead of silently measuring a hot page cache.
+ * start_at is first converted to nearest, lower power of two and then it is clamped at 2**18
+ * end_at is first converted to nearest, higher power of two and then it is clamped at 2**26.
+ *
+ *
+ * Returns grid of <size, ns taken for each method> values.
+ */
+measurement_grid measure_file_access(std::size_t start_at, std::size_t end_at, file_order order, bool cold){
+    start_at = lower_power_of_2(std::max(start_at, smallest_file));
+    end_at = upper_power_of_2(std::min(end_at, largest_file));
+
+    measurement_grid results;
+
+    for (auto n = end_at; n >= start_at; n /= 2){
+        trace_phase phase("generate", n);
+        temp_int_file file(generate_random_sequence(n));
+        std::vector<std::size_t> pages;
+        if (order == file_order::sequential){
+            pages.resize((file.size() + page_size() - 1) / page_size());
+            std::iota(begin(pages), end(pages), std::size_t(0));
+        } else {
+            pages = shuffled_pages(file);
+        }
+
+        phase.next("measure");
+        const bool evictable = !cold || file.drop_cache();
+        if (!evictable){
+            std::cerr << "Cannot evict " << file.size() << " byte file from the page cache, reporting 0. "
+                      << "TMPDIR has to be on a filesystem backed by a block device, not tmpfs." << std::endl;
+        }
+        std::vector<std::uint64_t> row;
+        auto measure = [&](auto method){
+            auto run = [&](){ return static_cast<int>(method()); };
+            if (!evictable){
+                row.push_back(0);
+            } else if (cold){
+                row.push_back(bench_with_setup([&](){ file.drop_cache(); }, run, rep_count).count());
+            } else {
+                run();
+                row.push_back(bench(run, rep_count).count());
+            }
+        };
+
+        measure([&](){ return sum_mapped(file, pages, page_advice::normal, false); });
+        if (order == file_order::sequential){
+            measure([&](){ return sum_mapped(file, pages, page_advice::sequential, false); });
+            measure([&](){ return sum_mapped(file, pages, page_advice::willneed, false); });
+        } else {
+            measure([&](){ return sum_mapped(file, pages, page_advice::random, false); });
+        }
+        measure([&](){ return sum_mapped(file, pages, page_advice::normal, true); });
+        if (order == file_order::sequential){
+            for (auto buffer_size : read_buffer_sizes){
+                measure([&](){ return sum_read_sequential(file, buffer_size); });
+            }
+        } else {
+            measure([&](){ return sum_read_pages(file, pages); });
+        }
+
+        results.emplace_back(n * sizeof(int), std::move(row));
+    }
+
+    std::reverse(begin(results), end(results));
+    return results;
+}
+
+enum class thread_placement {
+    unpinned,
+    same_cpu,    //Both threads time-share one CPU.
+    smt_sibling, //Other hardware thread of the same core, sharing L1 and L2.
+    same_llc,    //Another core behind the same last level cache.
+    other_llc    //A core behind a different last level cache, which is another CCX or socket.
+};
+
+constexpr thread_placement thread_placements[] = {
+    thread_placement::unpinned, thread_placement::same_cpu, thread_placement::smt_sibling, thread_placement::same_llc, thread_placement::other_llc
+};
+
+const char* placement_name(thread_placement placement){
+    switch (placement){
+    case thread_placement::same_cpu: return "Same CPU";
+    case thread_placement::smt_sibling: return "SMT sibling";
+    case thread_placement::same_llc: return "Same LLC";
+    case thread_placement::other_llc: return "Other LLC";
+    default: return "Unpinned";
+    }
+}
+
+struct thread_pair_cpus {
+    unsigned first = 0;
+    unsigned second = 0;
+};
+
+/* Picks CPUs for the two threads of a pair, according to cpu_topology and skipping reserved CPUs.
+ *
+ * Returns false if there is no such pair of CPUs, unpinned placement always succeeds and leaves cpus alone.
+ */
+bool pick_placement(thread_placement placement, thread_pair_cpus& cpus){
+    if (placement == thread_placement::unpinned){
+        return true;
+    }
+    auto topology = cpu_topology();
+    topology.erase(std::remove_if(begin(topology), end(topology), [](const cpu_info& info){ return cpu_reserved(info.cpu); }), end(topology));
+
+    for (const auto& a : topology){
+        for (const auto& b : topology){
+            bool fits = false;
+            switch (placement){
+            case thread_placement::same_cpu: fits = a.cpu == b.cpu; break;
+            case thread_placement::smt_sibling: fits = a.cpu != b.cpu && a.core == b.core; break;
+            case thread_placement::same_llc: fits = a.core != b.core && a.llc == b.llc; break;
+            case thread_placement::other_llc: fits = a.llc != b.llc; break;
+            default: break;
+            }
+            if (fits){
+                cpus.first = a.cpu;
+                cpus.second = b.cpu;
+                return true;
+            }
+        }
+    }
+    std::cerr << "No CPUs for " << placement_name(placement) << " placement, reporting 0." << std::endl;
+    return false;
+}
+
+//Pins the calling thread to cpu, or lets it run on any allowed CPU for unpinned placement.
+bool place_thread(thread_placement placement, unsigned cpu){
+    if (placement == thread_placement::unpinned){
+        return unpin_current_thread();
+    }
+    return pin_current_thread(cpu);
+}
+
+void report_unplaced(thread_placement placement, const thread_pair_cpus& cpus){
+    if (placement == thread_placement::unpinned){
+        std::cerr << "Cannot unpin queue threads, reporting 0." << std::endl;
+    } else {
+        std::cerr << "Cannot pin queue threads to CPUs " << cpus.first << " and " << cpus.second << ", reporting 0." << std::endl;
+    }
+}
+
+/* Measures throughput of Queue, with pairs producers and pairs consumers passing queue_messages messages in total.
+ *
+ * Threads are started and placed before the clock starts, every repetition uses a fresh queue.
+ *
+ *
+ * Returns messages per second, or 0 if the threads could not be placed.
+ */
+template <typename Queue>
+std::uint64_t measure_queue_throughput(std::size_t pairs, thread_placement placement){
+    using message = typename Queue::value_type;
+    const std::size_t per_producer = queue_messages / pairs;
+    thread_pair_cpus cpus;
+    if (!pick_placement(placement, cpus)){
+        return 0;
+    }
+
+    std::chrono::nanoseconds total(0);
+    for (std::size_t rep = 0; rep < rep_count; ++rep){
+        Queue queue;
+        std::atomic<bool> start{false}, placed{true};
+        std::vector<std::uint32_t> checksums(pairs);
+        std::vector<std::thread> threads;
+
+        for (std::size_t p = 0; p < pairs; ++p){
+            threads.emplace_back([&](){
+                if (!place_thread(placement, cpus.first)){
+                    placed = false;
+                }
+                while (!start.load(std::memory_order_acquire)){
+                    std::this_thread::yield();
+                }
+                message msg{};
+                for (std::size_t i = 0; i < per_producer; ++i){
+                    msg.stuffing[0] = static_cast<std::uint8_t>(i);
+                    queue.push(msg);
+                }
+            });
+            threads.emplace_back([&, p](){
+                if (!place_thread(placement, cpus.second)){
+                    placed = false;
+                }
+                while (!start.load(std::memory_order_acquire)){
+                    std::this_thread::yield();
+                }
+                message msg;
+                std::uint32_t temp = 0;
+                for (std::size_t i = 0; i < per_producer; ++i){
+                    queue.pop(msg);
+                    temp += msg.stuffing[0];
+                }
+                checksums[p] = temp;
+            });
+        }
+
+        auto t1 = std::chrono::steady_clock::now();
+        start.store(true, std::memory_order_release);
+        for (auto& thread : threads){
+            thread.join();
+        }
+        auto t2 = std::chrono::steady_clock::now();
+        total += t2 - t1;
+        if (!placed){
+            report_unplaced(placement, cpus);
+            return 0;
+        }
+
+        static volatile std::uint32_t c = 0;
+        c = c + std::accumulate(begin(checksums), end(checksums), std::uint32_t(0));
+    }
+
+    return pairs * per_producer * rep_count * std::uint64_t(1000000000) / std::max<std::uint64_t>(total.count(), 1);
+}
+
+/* Measures round trip latency of Queue, one thread sends a message and waits for the other one to send it back.
+ *
+ *
+ * Returns ns taken by a round trip, at each of latency_percentiles, or zeros if the threads could not be placed.
+ */
+template <typename Queue>
+std::vector<std::uint64_t> measure_queue_latency(thread_placement placement){
+    using message = typename Queue::value_type;
+    const auto none = std::extent<decltype(latency_percentiles)>::value;
+    thread_pair_cpus cpus;
+    if (!pick_placement(placement, cpus)){
+        return std::vector<std::uint64_t>(none);
+    }
+    Queue ping, pong;
+    std::vector<std::uint64_t> samples(queue_round_trips);
+    std::atomic<bool> placed{true};
+
+    std::thread echo([&](){
+        if (!place_thread(placement, cpus.second)){
+            placed = false;
+        }
+        message msg;
+        for (std::size_t i = 0; i < queue_round_trips; ++i){
+            ping.pop(msg);
+            pong.push(msg);
+        }
+    });
+    std::thread sender([&](){
+        if (!place_thread(placement, cpus.first)){
+            placed = false;
+        }
+        message msg{};
+        for (auto& sample : samples){
+            auto t1 = std::chrono::steady_clock::now();
+            ping.push(msg);
+            pong.pop(msg);
+            auto t2 = std::chrono::steady_clock::now();
+            sample = std::chrono::duration_cast<std::chrono::nanoseconds>(t2 - t1).count();
+        }
+    });
+    sender.join();
+    echo.join();
+    if (!placed){
+        report_unplaced(placement, cpus);
+        return std::vector<std::uint64_t>(none);
+    }
+
+    std::sort(begin(samples), end(samples));
+    std::vector<std::uint64_t> results;
+    for (auto percentile : latency_percentiles){
+        auto index = static_cast<std::size_t>(samples.size() * percentile / 100);
+        results.push_back(samples[std::min(index, samples.size() - 1)]);
+    }
+    return results;
+}
+
+template <typename Queue>
+std::pair<int, std::vector<std::uint64_t>> measure_queue_placement_row(){
+    std::vector<std::uint64_t> row;
+    for (auto placement : thread_placements){
+        row.push_back(measure_queue_throughput<Queue>(1, placement));
+    }
+    return {static_cast<int>(sizeof(typename Queue::value_type)), std::move(row)};
+}
+
+/* Runs measure_queue_throughput with a single producer and consumer, for each of thread_placements.
+ *
+ * QueueOf maps message type to the queue type to be measured.
+ *
+ *
+ * Returns grid of <message size, messages per second for each placement> values.
+ */
+template <template <typename> class QueueOf, std::size_t... Sizes>
+measurement_grid measure_queue_placements(){
+    return {measure_queue_placement_row<QueueOf<payload<Sizes>>>()...};
+}
+
+/* Runs measure_queue_latency for messages of each of the given Sizes.
+ *
+ *
+ * Returns grid of <message size, ns taken at each of latency_percentiles> values.
+ */
+template <template <typename> class QueueOf, std::size_t... Sizes>
+measurement_grid measure_queue_latencies(thread_placement placement){
+    return {{static_cast<int>(Sizes), measure_queue_latency<QueueOf<payload<Sizes>>>(placement)}...};
+}
+
+/* Runs measure_queue_throughput with 1 to half of allowed_cpus producers, and as many consumers, unpinned.
+ *
+ *
+ * Returns grid of <producers, messages per second for each of the message Sizes> values.
+ */
+template <template <typename> class QueueOf, std::size_t... Sizes>
+measurement_grid measure_queue_contention(){
+    const std::size_t max_pairs = std::max<std::size_t>(allowed_cpus().size() / 2, 1);
+    measurement_grid results;
+    for (std::size_t pairs = 1; pairs <= max_pairs; pairs *= 2){
+        results.emplace_back(pairs, std::vector<std::uint64_t>{measure_queue_throughput<QueueOf<payload<Sizes>>>(pairs, thread_placement::unpinned)...});
+    }
+    return results;
+}
+
 #endif
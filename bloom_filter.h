@@ -0,0 +1,134 @@
+#pragma once
+#ifndef WTF_BLOOM_FILTER
+#define WTF_BLOOM_FILTER
+
+#include <vector>
+#include <cstdint>
+#include <algorithm>
+#include <utility>
+
+#include "aligned_allocator.h"
+#include "hash_table.h"
+#include "utilities.h"
+
+constexpr std::size_t bloom_bits_per_key = 12;
+constexpr std::size_t bloom_probes = 6;
+
+/* Bloom filter, where all probes for a key land in a single cache line, so a query costs at most one miss.
+ *
+ * That makes the false positive rate somewhat worse than for a classic filter of the same size,
+ * which is paid for by using bloom_bits_per_key bits for every key.
+ */
+class blocked_bloom_filter {
+    static constexpr std::size_t line_bits = cache_line_size * 8;
+
+    struct alignas(cache_line_size) line {
+        std::uint64_t words[cache_line_size / sizeof(std::uint64_t)];
+    };
+
+public:
+    explicit blocked_bloom_filter(std::size_t expected)
+    :lines(upper_power_of_2(std::max<std::size_t>(expected * bloom_bits_per_key / line_bits, 1)), line{}){}
+
+    void insert(std::uint32_t key){
+        auto hash = hash_key(key);
+        auto& block = lines[line_of(hash)];
+        for (std::size_t i = 0; i < bloom_probes; ++i){
+            auto bit = probe(hash, i);
+            block.words[bit / 64] |= std::uint64_t{1} << (bit % 64);
+        }
+    }
+
+    //Returns false only if the key was never inserted.
+    bool may_contain(std::uint32_t key) const {
+        auto hash = hash_key(key);
+        const auto& block = lines[line_of(hash)];
+        for (std::size_t i = 0; i < bloom_probes; ++i){
+            auto bit = probe(hash, i);
+            if (!(block.words[bit / 64] & (std::uint64_t{1} << (bit % 64)))){
+                return false;
+            }
+        }
+        return true;
+    }
+
+    std::size_t capacity() const {
+        return lines.size() * line_bits / bloom_bits_per_key;
+    }
+
+private:
+    //Multiply-shift, so the line is picked by the high bits of the hash and the low bits stay for the probes.
+    std::size_t line_of(std::uint32_t hash) const {
+        return (static_cast<std::uint64_t>(hash) * lines.size()) >> 32;
+    }
+
+    //Double hashing, with the second hash derived by re-mixing the first one.
+    static std::size_t probe(std::uint32_t hash, std::size_t i){
+        auto step = hash_key(hash ^ 0x9e3779b9) | 1;
+        return (hash + i * step) % line_bits;
+    }
+
+    std::vector<line, aligned_allocator<line>> lines;
+};
+
+/* Blocked Bloom filter in front of any map-like Container, so that lookups of missing keys
+ * usually return end() without ever touching the Container.
+ *
+ * The filter starts small and is rebuilt from the Container's keys whenever it fills up,
+ * so that it can be filled through std::inserter like the plain containers.
+ */
+template <typename Container>
+class bloom_fronted {
+public:
+    using iterator = typename Container::iterator;
+    using value_type = typename Container::value_type;
+    using mapped_type = typename Container::mapped_type;
+    using key_type = typename Container::key_type;
+
+    iterator find(const key_type& key){
+        if (!filter.may_contain(static_cast<std::uint32_t>(key))){
+            return data.end();
+        }
+        return data.find(key);
+    }
+
+    std::pair<iterator, bool> insert(const value_type& elem){
+        auto result = data.insert(elem);
+        if (result.second){
+            added(elem.first);
+        }
+        return result;
+    }
+
+    iterator insert(iterator position, const value_type& elem){
+        auto it = data.insert(position, elem);
+        added(elem.first);
+        return it;
+    }
+
+    iterator begin(){
+        return data.begin();
+    }
+
+    iterator end(){
+        return data.end();
+    }
+
+private:
+    void added(const key_type& key){
+        if (++count <= filter.capacity()){
+            filter.insert(static_cast<std::uint32_t>(key));
+            return;
+        }
+        filter = blocked_bloom_filter(count * 2);
+        for (const auto& elem : data){
+            filter.insert(static_cast<std::uint32_t>(elem.first));
+        }
+    }
+
+    Container data;
+    blocked_bloom_filter filter{0};
+    std::size_t count = 0;
+};
+
+#endif
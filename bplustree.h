@@ -0,0 +1,298 @@
+#pragma once
+#ifndef WTF_BPLUSTREE
+#define WTF_BPLUSTREE
+
+#include <algorithm>
+#include <iterator>
+#include <utility>
+#include <new>
+
+#include "aligned_allocator.h"
+
+/* B+tree with nodes sized to NodeLines cache lines worth of keys.
+ *
+ * Leaves keep keys and values in separate arrays, so that searching a leaf only touches the key lines,
+ * and are linked together for range scans. Inner nodes only hold keys and child pointers.
+ * Supports the same find/insert interface as flatmap, but only forward iteration and no erasure.
+ */
+template <typename Key, typename Value, std::size_t NodeLines = 4>
+class bplustree {
+    static constexpr std::size_t capacity = NodeLines * cache_line_size / sizeof(Key);
+    static_assert(capacity >= 3, "Node has to fit at least 3 keys.");
+
+    struct node {
+        std::size_t count = 0;
+    };
+
+    struct leaf : node {
+        alignas(cache_line_size) Key keys[capacity];
+        leaf* next = nullptr;
+        Value values[capacity];
+    };
+
+    //keys[i] is the smallest key reachable through children[i + 1].
+    struct inner : node {
+        alignas(cache_line_size) Key keys[capacity];
+        node* children[capacity + 1];
+    };
+
+public:
+    using key_type = Key;
+    using mapped_type = Value;
+    using value_type = std::pair<const Key, Value>;
+
+    class iterator {
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = std::pair<const Key, Value>;
+        using difference_type = std::ptrdiff_t;
+        using reference = std::pair<const Key&, Value&>;
+
+        //Elements are not stored as pairs, so -> has to go through a temporary.
+        struct pointer {
+            reference ref;
+            reference* operator->(){
+                return &ref;
+            }
+        };
+
+        iterator(){}
+        iterator(leaf* current, std::size_t position)
+        :current{current}, position{position}{}
+
+        reference operator*() const {
+            return reference(current->keys[position], current->values[position]);
+        }
+
+        pointer operator->() const {
+            return pointer{**this};
+        }
+
+        iterator& operator++(){
+            if (++position == current->count){
+                current = current->next;
+                position = 0;
+            }
+            return *this;
+        }
+
+        iterator operator++(int){
+            auto temp = *this;
+            ++*this;
+            return temp;
+        }
+
+        bool operator==(const iterator& rhs) const {
+            return current == rhs.current && position == rhs.position;
+        }
+
+        bool operator!=(const iterator& rhs) const {
+            return !(*this == rhs);
+        }
+
+    private:
+        leaf* current = nullptr;
+        std::size_t position = 0;
+    };
+
+    bplustree()
+    :root{make_node<leaf>()}{}
+
+    template <typename InputIterator>
+    bplustree(InputIterator first, InputIterator last)
+    :bplustree(){
+        for (; first != last; ++first){
+            insert(*first);
+        }
+    }
+
+    bplustree(const bplustree&) = delete;
+    bplustree& operator=(const bplustree&) = delete;
+
+    ~bplustree(){
+        destroy(root, height);
+    }
+
+    std::pair<iterator, bool> insert(const value_type& elem){
+        iterator where;
+        Key separator{};
+        node* right = nullptr;
+        bool inserted = insert_into(root, height, elem, where, separator, right);
+        if (right){
+            auto new_root = make_node<inner>();
+            new_root->count = 1;
+            new_root->keys[0] = separator;
+            new_root->children[0] = root;
+            new_root->children[1] = right;
+            root = new_root;
+            ++height;
+        }
+        return {where, inserted};
+    }
+
+    //Hint is ignored, the position is always searched from the root.
+    iterator insert(iterator, const value_type& elem){
+        return insert(elem).first;
+    }
+
+    iterator find(const key_type& key){
+        auto l = find_leaf(key);
+        std::size_t pos = std::lower_bound(l->keys, l->keys + l->count, key) - l->keys;
+        if (pos != l->count && l->keys[pos] == key){
+            return iterator(l, pos);
+        }
+        return end();
+    }
+
+    iterator lower_bound(const key_type& key){
+        auto l = find_leaf(key);
+        std::size_t pos = std::lower_bound(l->keys, l->keys + l->count, key) - l->keys;
+        if (pos == l->count){
+            return iterator(l->next, 0);
+        }
+        return iterator(l, pos);
+    }
+
+    iterator begin(){
+        node* n = root;
+        for (auto level = height; level > 0; --level){
+            n = static_cast<inner*>(n)->children[0];
+        }
+        auto l = static_cast<leaf*>(n);
+        return l->count == 0 ? end() : iterator(l, 0);
+    }
+
+    iterator end(){
+        return iterator();
+    }
+
+private:
+    template <typename Node>
+    static Node* make_node(){
+        return new (aligned_allocator<Node>().allocate(1)) Node();
+    }
+
+    template <typename Node>
+    static void free_node(Node* n){
+        n->~Node();
+        aligned_allocator<Node>().deallocate(n, 1);
+    }
+
+    static void destroy(node* n, std::size_t level){
+        if (level == 0){
+            free_node(static_cast<leaf*>(n));
+            return;
+        }
+        auto in = static_cast<inner*>(n);
+        for (std::size_t i = 0; i <= in->count; ++i){
+            destroy(in->children[i], level - 1);
+        }
+        free_node(in);
+    }
+
+    static std::size_t child_index(const inner* in, const key_type& key){
+        return std::upper_bound(in->keys, in->keys + in->count, key) - in->keys;
+    }
+
+    leaf* find_leaf(const key_type& key) const {
+        node* n = root;
+        for (auto level = height; level > 0; --level){
+            auto in = static_cast<inner*>(n);
+            n = in->children[child_index(in, key)];
+        }
+        return static_cast<leaf*>(n);
+    }
+
+    /* Inserts elem into subtree rooted at n, that is level levels above leaves.
+     *
+     * If n had to be split, right is set to the new right sibling and separator to its smallest key.
+     */
+    static bool insert_into(node* n, std::size_t level, const value_type& elem, iterator& where, Key& separator, node*& right){
+        if (level == 0){
+            return insert_into_leaf(static_cast<leaf*>(n), elem, where, separator, right);
+        }
+
+        auto in = static_cast<inner*>(n);
+        auto idx = child_index(in, elem.first);
+        Key child_separator{};
+        node* child_right = nullptr;
+        bool inserted = insert_into(in->children[idx], level - 1, elem, where, child_separator, child_right);
+        if (!child_right){
+            return inserted;
+        }
+
+        if (in->count < capacity){
+            std::copy_backward(in->keys + idx, in->keys + in->count, in->keys + in->count + 1);
+            std::copy_backward(in->children + idx + 1, in->children + in->count + 1, in->children + in->count + 2);
+            in->keys[idx] = child_separator;
+            in->children[idx + 1] = child_right;
+            ++in->count;
+            return inserted;
+        }
+
+        //Full node, lay out all capacity + 1 keys and then split them in half, middle key moves up.
+        Key keys[capacity + 1];
+        node* children[capacity + 2];
+        std::copy(in->keys, in->keys + idx, keys);
+        keys[idx] = child_separator;
+        std::copy(in->keys + idx, in->keys + capacity, keys + idx + 1);
+        std::copy(in->children, in->children + idx + 1, children);
+        children[idx + 1] = child_right;
+        std::copy(in->children + idx + 1, in->children + capacity + 1, children + idx + 2);
+
+        const auto mid = (capacity + 1) / 2;
+        auto sibling = make_node<inner>();
+        in->count = mid;
+        std::copy(keys, keys + mid, in->keys);
+        std::copy(children, children + mid + 1, in->children);
+        sibling->count = capacity - mid;
+        std::copy(keys + mid + 1, keys + capacity + 1, sibling->keys);
+        std::copy(children + mid + 1, children + capacity + 2, sibling->children);
+
+        separator = keys[mid];
+        right = sibling;
+        return inserted;
+    }
+
+    static bool insert_into_leaf(leaf* l, const value_type& elem, iterator& where, Key& separator, node*& right){
+        std::size_t pos = std::lower_bound(l->keys, l->keys + l->count, elem.first) - l->keys;
+        if (pos != l->count && l->keys[pos] == elem.first){
+            where = iterator(l, pos);
+            return false;
+        }
+
+        if (l->count == capacity){
+            const auto mid = capacity / 2;
+            auto sibling = make_node<leaf>();
+            sibling->count = capacity - mid;
+            std::move(l->keys + mid, l->keys + capacity, sibling->keys);
+            std::move(l->values + mid, l->values + capacity, sibling->values);
+            l->count = mid;
+            sibling->next = l->next;
+            l->next = sibling;
+            right = sibling;
+
+            if (pos > mid){
+                l = sibling;
+                pos -= mid;
+            }
+        }
+
+        std::move_backward(l->keys + pos, l->keys + l->count, l->keys + l->count + 1);
+        std::move_backward(l->values + pos, l->values + l->count, l->values + l->count + 1);
+        l->keys[pos] = elem.first;
+        l->values[pos] = elem.second;
+        ++l->count;
+        where = iterator(l, pos);
+
+        if (right){
+            separator = static_cast<leaf*>(right)->keys[0];
+        }
+        return true;
+    }
+
+    node* root;
+    std::size_t height = 0;
+};
+
+#endif
@@ -0,0 +1,160 @@
+#pragma once
+#ifndef WTF_COMPRESSED_FLATMAP
+#define WTF_COMPRESSED_FLATMAP
+
+#include <vector>
+#include <utility>
+#include <algorithm>
+#include <limits>
+#include <cstdint>
+#include <type_traits>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+#include "aligned_allocator.h"
+
+/* Compares one 16 byte chunk of deltas against a needle, returning a byte mask like _mm_movemask_epi8.
+ */
+template <typename Delta>
+struct delta_compare;
+
+#if defined(__SSE2__)
+template <>
+struct delta_compare<std::uint8_t> {
+    static unsigned matches(const std::uint8_t* chunk, std::uint8_t needle){
+        auto lanes = _mm_load_si128(reinterpret_cast<const __m128i*>(chunk));
+        return _mm_movemask_epi8(_mm_cmpeq_epi8(lanes, _mm_set1_epi8(static_cast<char>(needle))));
+    }
+};
+
+template <>
+struct delta_compare<std::uint16_t> {
+    static unsigned matches(const std::uint16_t* chunk, std::uint16_t needle){
+        auto lanes = _mm_load_si128(reinterpret_cast<const __m128i*>(chunk));
+        return _mm_movemask_epi8(_mm_cmpeq_epi16(lanes, _mm_set1_epi16(static_cast<short>(needle))));
+    }
+};
+#endif
+
+/* Read only sorted map of integer keys, which stores the keys as blocks of narrow deltas from a per block base.
+ *
+ * Every block is one cache line of Delta-sized deltas, so with 8 bit deltas a line holds 64 keys instead of 8 key-value pairs.
+ * A new block starts whenever the current one is full or the next key is too far from its base, so sparse keys
+ * just make for emptier blocks. Block bases form the top-level index, which is binary searched to pick the block,
+ * and the block is then scanned with SSE2 compares, or with a plain loop where SSE2 is not available.
+ * Values are kept in a separate array, in key order.
+ */
+template <typename Key, typename Value, typename Delta = std::uint16_t>
+class compressed_flatmap {
+    static_assert(std::is_integral<Key>::value, "Keys are stored as deltas, so they must be integers.");
+    static_assert(std::is_unsigned<Delta>::value && sizeof(Delta) <= sizeof(Key), "Deltas must be unsigned and no wider than keys.");
+
+    using unsigned_key = typename std::make_unsigned<Key>::type;
+    static constexpr std::size_t block_keys = cache_line_size / sizeof(Delta);
+    static constexpr unsigned_key max_delta = std::numeric_limits<Delta>::max();
+
+    struct alignas(cache_line_size) block {
+        Delta deltas[block_keys];
+    };
+
+public:
+    using value_type = std::pair<Key, Value>;
+    using mapped_type = Value;
+    using key_type = Key;
+
+    compressed_flatmap(){}
+
+    template <typename InputIterator>
+    compressed_flatmap(InputIterator first, InputIterator last){
+        std::vector<value_type> elements(first, last);
+        std::sort(begin(elements), end(elements), [](const value_type& lhs, const value_type& rhs){ return lhs.first < rhs.first; });
+
+        values.reserve(elements.size());
+        std::size_t fill = block_keys;
+        for (const auto& elem : elements){
+            if (fill == block_keys || delta_of(bases.back(), elem.first) > max_delta){
+                bases.push_back(elem.first);
+                starts.push_back(static_cast<std::uint32_t>(values.size()));
+                blocks.emplace_back();
+                std::fill(std::begin(blocks.back().deltas), std::end(blocks.back().deltas), static_cast<Delta>(max_delta));
+                fill = 0;
+            }
+            blocks.back().deltas[fill++] = static_cast<Delta>(delta_of(bases.back(), elem.first));
+            values.push_back(elem.second);
+        }
+        starts.push_back(static_cast<std::uint32_t>(values.size()));
+        bases.shrink_to_fit();
+        starts.shrink_to_fit();
+        blocks.shrink_to_fit();
+    }
+
+    //Returns pointer to the value stored for key, or nullptr if the key is missing.
+    const Value* find(const key_type& key) const {
+        auto it = std::upper_bound(std::begin(bases), std::end(bases), key);
+        if (it == std::begin(bases)){
+            return nullptr;
+        }
+        const std::size_t index = it - std::begin(bases) - 1;
+        auto delta = delta_of(bases[index], key);
+        if (delta > max_delta){
+            return nullptr;
+        }
+        auto position = find_delta(blocks[index], static_cast<Delta>(delta));
+        if (position >= starts[index + 1] - starts[index]){
+            return nullptr;
+        }
+        return &values[starts[index] + position];
+    }
+
+    std::size_t size() const {
+        return values.size();
+    }
+
+private:
+    static unsigned_key delta_of(key_type from, key_type to){
+        return static_cast<unsigned_key>(static_cast<unsigned_key>(to) - static_cast<unsigned_key>(from));
+    }
+
+    //Returns the position of the first delta equal to needle, or block_keys if there is none. Padding has to be masked out by the caller.
+    static std::size_t find_delta(const block& b, Delta needle){
+#if defined(__SSE2__)
+        constexpr std::size_t chunk = 16 / sizeof(Delta);
+        for (std::size_t i = 0; i < block_keys; i += chunk){
+            auto mask = delta_compare<Delta>::matches(b.deltas + i, needle);
+            if (mask){
+                return i + lowest_set_bit(mask) / sizeof(Delta);
+            }
+        }
+        return block_keys;
+#else
+        return std::find(std::begin(b.deltas), std::end(b.deltas), needle) - std::begin(b.deltas);
+#endif
+    }
+
+    static std::size_t lowest_set_bit(unsigned mask){
+#if defined(__GNUC__)
+        return __builtin_ctz(mask);
+#else
+        std::size_t bit = 0;
+        while (!(mask & 1)){
+            mask >>= 1;
+            ++bit;
+        }
+        return bit;
+#endif
+    }
+
+    std::vector<key_type> bases;
+    std::vector<std::uint32_t> starts; //Index of the first value of every block, plus one past the last value.
+    std::vector<block, aligned_allocator<block>> blocks;
+    std::vector<Value> values;
+};
+
+template <typename Key, typename Value, typename Delta>
+const Value* find_value(const compressed_flatmap<Key, Value, Delta>& data, const Key& key){
+    return data.find(key);
+}
+
+#endif
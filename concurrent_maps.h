@@ -0,0 +1,215 @@
+#pragma once
+#ifndef WTF_CONCURRENT_MAPS
+#define WTF_CONCURRENT_MAPS
+
+#include <map>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <atomic>
+#include <utility>
+#include <algorithm>
+#include <cassert>
+
+#include "flatmap.h"
+
+/* All of the maps here share the same interface:
+ *  - constructor from a range of key, value pairs and a capacity hint (total number of elements it will ever hold)
+ *  - insert, that can be called from a single writer thread at a time
+ *  - nested reader class, that every reader thread constructs once and then does lookups through it.
+ *    find calls f with the found element and returns whether the key was found.
+ */
+
+/* std::map behind a reader-writer lock.
+ */
+template <typename Key, typename Value>
+class locked_map {
+public:
+    using value_type = std::pair<const Key, Value>;
+
+    template <typename InputIterator>
+    locked_map(InputIterator first, InputIterator last, std::size_t)
+    :data(first, last){}
+
+    bool insert(const value_type& elem){
+        std::unique_lock<std::shared_timed_mutex> lock(mutex);
+        return data.insert(elem).second;
+    }
+
+    class reader {
+    public:
+        explicit reader(const locked_map& map)
+        :map(map){}
+
+        template <typename Func>
+        bool find(const Key& key, Func f){
+            std::shared_lock<std::shared_timed_mutex> lock(map.mutex);
+            auto it = map.data.find(key);
+            if (it == map.data.end()){
+                return false;
+            }
+            f(*it);
+            return true;
+        }
+
+    private:
+        const locked_map& map;
+    };
+
+private:
+    std::map<Key, Value> data;
+    mutable std::shared_timed_mutex mutex;
+};
+
+/* Flatmap, whose immutable snapshots are replaced on every write (RCU-style copy on write).
+ *
+ * Readers keep the snapshot they last saw pinned and only reload it when the version counter changes,
+ * so the lookup path does not write to any shared cache line.
+ * Old snapshot is freed when the last reader moves off it.
+ */
+template <typename Key, typename Value>
+class rcu_flatmap {
+    using snapshot = flatmap<Key, Value>;
+
+public:
+    using value_type = typename snapshot::value_type;
+
+    template <typename InputIterator>
+    rcu_flatmap(InputIterator first, InputIterator last, std::size_t)
+    :current(std::make_shared<const snapshot>(first, last)){}
+
+    bool insert(const value_type& elem){
+        std::lock_guard<std::mutex> lock(writer_mutex);
+        auto next = std::make_shared<snapshot>(*std::atomic_load(&current));
+        if (!next->insert(elem).second){
+            return false;
+        }
+        assert(std::is_sorted(next->begin(), next->end(), [](const value_type& lhs, const value_type& rhs){ return lhs.first < rhs.first; })
+               && "Snapshot has to stay sorted for readers' binary search.");
+        std::atomic_store(&current, std::shared_ptr<const snapshot>(std::move(next)));
+        version.fetch_add(1, std::memory_order_release);
+        return true;
+    }
+
+    class reader {
+    public:
+        explicit reader(const rcu_flatmap& map)
+        :map(map), seen(map.version.load(std::memory_order_acquire)), pinned(std::atomic_load(&map.current)){}
+
+        template <typename Func>
+        bool find(const Key& key, Func f){
+            auto latest = map.version.load(std::memory_order_acquire);
+            if (latest != seen){
+                pinned = std::atomic_load(&map.current);
+                seen = latest;
+            }
+            auto it = pinned->find(key);
+            if (it == pinned->end()){
+                return false;
+            }
+            f(*it);
+            return true;
+        }
+
+    private:
+        const rcu_flatmap& map;
+        std::uint64_t seen;
+        std::shared_ptr<const snapshot> pinned;
+    };
+
+private:
+    std::shared_ptr<const snapshot> current;
+    std::atomic<std::uint64_t> version{0};
+    std::mutex writer_mutex;
+};
+
+/* Sorted array protected by a sequence lock.
+ *
+ * Storage is allocated for the whole capacity up front, so it never moves and readers can
+ * always safely walk it. Readers retry whenever a write overlapped with their lookup,
+ * which means that f can be called more than once and has to tolerate seeing torn elements.
+ * Strictly speaking, the optimistic reads are a data race, as with every seqlock written in plain C++.
+ */
+template <typename Key, typename Value>
+class seqlock_flatmap {
+public:
+    using value_type = std::pair<Key, Value>;
+
+    template <typename InputIterator>
+    seqlock_flatmap(InputIterator first, InputIterator last, std::size_t capacity)
+    :storage(new value_type[capacity]), capacity(capacity){
+        auto it = std::copy(first, last, storage.get());
+        std::sort(storage.get(), it, [](const value_type& lhs, const value_type& rhs) {return lhs.first < rhs.first;});
+        count.store(it - storage.get(), std::memory_order_relaxed);
+    }
+
+    bool insert(const value_type& elem){
+        std::lock_guard<std::mutex> lock(writer_mutex);
+        auto size = count.load(std::memory_order_relaxed);
+        if (size == capacity){
+            return false;
+        }
+        auto first = storage.get();
+        auto last = first + size;
+        auto it = lower_bound(first, last, elem.first);
+        if (it != last && it->first == elem.first){
+            return false;
+        }
+
+        auto seq = sequence.load(std::memory_order_relaxed);
+        sequence.store(seq + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+
+        std::move_backward(it, last, last + 1);
+        *it = elem;
+        count.store(size + 1, std::memory_order_relaxed);
+
+        sequence.store(seq + 2, std::memory_order_release);
+        return true;
+    }
+
+    class reader {
+    public:
+        explicit reader(const seqlock_flatmap& map)
+        :map(map){}
+
+        template <typename Func>
+        bool find(const Key& key, Func f){
+            while (true){
+                auto before = map.sequence.load(std::memory_order_acquire);
+                if (before & 1){
+                    continue;
+                }
+
+                auto first = map.storage.get();
+                auto last = first + map.count.load(std::memory_order_relaxed);
+                auto it = lower_bound(first, last, key);
+                bool found = it != last && it->first == key;
+                if (found){
+                    f(*it);
+                }
+
+                std::atomic_thread_fence(std::memory_order_acquire);
+                if (map.sequence.load(std::memory_order_relaxed) == before){
+                    return found;
+                }
+            }
+        }
+
+    private:
+        const seqlock_flatmap& map;
+    };
+
+private:
+    static value_type* lower_bound(value_type* first, value_type* last, const Key& key){
+        return std::lower_bound(first, last, key, [](const value_type& val, const Key& key) {return val.first < key;});
+    }
+
+    std::unique_ptr<value_type[]> storage;
+    std::size_t capacity;
+    std::atomic<std::size_t> count{0};
+    std::atomic<std::uint64_t> sequence{0};
+    std::mutex writer_mutex;
+};
+
+#endif
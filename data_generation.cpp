@@ -1,25 +1,31 @@
 #include <algorithm>
 #include <iterator>
 #include <random>
+#include <cstdint>
 
 #include "data_generation.h"
 
 
-matrix generate_matrix(std::size_t rows, std::size_t columns, std::size_t seed){
-    matrix temp(rows, columns);
+template <typename T>
+basic_matrix<T> generate_matrix(std::size_t rows, std::size_t columns, std::size_t seed, std::size_t padding){
+    basic_matrix<T> temp(rows, columns, padding);
 
     std::mt19937_64 rand(seed);
     std::uniform_real_distribution<> dist(1, 100);
 
     for (std::size_t r = 0; r < rows; ++r){
         for (std::size_t c = 0; c < columns; ++c){
-            temp(r, c) = dist(rand);
+            temp(r, c) = static_cast<T>(dist(rand));
         }
     }
 
     return temp;
 }
 
+template basic_matrix<float> generate_matrix<float>(std::size_t, std::size_t, std::size_t, std::size_t);
+template basic_matrix<double> generate_matrix<double>(std::size_t, std::size_t, std::size_t, std::size_t);
+template basic_matrix<std::int32_t> generate_matrix<std::int32_t>(std::size_t, std::size_t, std::size_t, std::size_t);
+
 
 std::vector<int> generate_random_sequence(std::size_t size, std::size_t seed){
     std::vector<int> temp;
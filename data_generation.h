@@ -3,12 +3,29 @@
 #define WTF_MATRIX_GENERATION
 
 #include <vector>
+#include <random>
+#include <algorithm>
 
 #include "matrix_multiplication.h"
 
-matrix generate_matrix(std::size_t rows, std::size_t columns, std::size_t seed = 0);
+template <typename T = double>
+basic_matrix<T> generate_matrix(std::size_t rows, std::size_t columns, std::size_t seed = 0, std::size_t padding = 0);
 std::vector<int> generate_random_sequence(std::size_t size, std::size_t seed = 0);
 
+//Unlike generate_random_sequence, the keys cover the whole range of Key.
+template <typename Key>
+std::vector<Key> generate_random_keys(std::size_t size, std::size_t seed = 0){
+    std::vector<Key> temp;
+    temp.reserve(size);
+
+    std::mt19937_64 rand(seed);
+    std::uniform_int_distribution<Key> dist;
+
+    std::generate_n(std::back_inserter(temp), size, [&](){return dist(rand);});
+
+    return temp;
+}
+
 struct generate_random_pairs {
     const std::size_t N;
     std::vector<int> seq;
@@ -24,8 +41,7 @@ struct generate_random_pairs {
 
         explicit iterator(generate_random_pairs& par, int pos) :
                 par(par),
-                pos(pos),
-                myp(pos, par.seq[pos]) {}
+                pos(pos) {}
 
         bool operator==(const iterator& rhs) {
             return &par == &rhs.par && pos == rhs.pos;
@@ -35,13 +51,14 @@ struct generate_random_pairs {
             return &par != &rhs.par || pos != rhs.pos;
         }
 
+        //Read on dereference, so that the end iterator never touches seq[N].
         std::pair<int, int>& operator*() {
+            myp = std::make_pair(pos, par.seq[pos]);
             return myp;
         }
 
         iterator& operator++() {
             ++pos;
-            myp = std::make_pair(pos, par.seq[pos]);
             return *this;
         }
     };
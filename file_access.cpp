@@ -0,0 +1,160 @@
+#include <algorithm>
+#include <cstdlib>
+#include <numeric>
+#include <random>
+#include <stdexcept>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include "file_access.h"
+
+namespace {
+
+std::uint32_t sum_ints(const char* data, std::size_t bytes){
+    auto first = reinterpret_cast<const int*>(data);
+    return std::accumulate(first, first + bytes / sizeof(int), std::uint32_t(0));
+}
+
+int to_madvise(page_advice advice){
+    switch (advice){
+    case page_advice::sequential: return MADV_SEQUENTIAL;
+    case page_advice::random: return MADV_RANDOM;
+    case page_advice::willneed: return MADV_WILLNEED;
+    default: return MADV_NORMAL;
+    }
+}
+
+//Keeps reading until count bytes arrived, pread may return less.
+void read_fully(int fd, char* buffer, std::size_t count, std::size_t offset){
+    while (count > 0){
+        auto got = pread(fd, buffer, count, offset);
+        if (got <= 0){
+            throw std::runtime_error("pread failed");
+        }
+        buffer += got;
+        count -= got;
+        offset += got;
+    }
+}
+
+}
+
+temp_int_file::temp_int_file(const std::vector<int>& contents)
+:bytes{contents.size() * sizeof(int)}{
+    const char* dir = std::getenv("TMPDIR");
+    path = std::string(dir ? dir : "/tmp") + "/cache-effect-benchmarks-XXXXXX";
+    fd = mkstemp(&path[0]);
+    if (fd < 0){
+        throw std::runtime_error("Cannot create temporary file in " + path);
+    }
+
+    auto data = reinterpret_cast<const char*>(contents.data());
+    std::size_t written = 0;
+    while (written < bytes){
+        auto done = write(fd, data + written, bytes - written);
+        if (done <= 0){
+            close(fd);
+            unlink(path.c_str());
+            throw std::runtime_error("Cannot write temporary file " + path);
+        }
+        written += done;
+    }
+    fsync(fd);
+}
+
+temp_int_file::~temp_int_file(){
+    close(fd);
+    unlink(path.c_str());
+}
+
+bool temp_int_file::drop_cache() const {
+#if defined(POSIX_FADV_DONTNEED) && defined(__linux__)
+    if (posix_fadvise(fd, 0, 0, POSIX_FADV_DONTNEED) != 0){
+        return false;
+    }
+    return resident_pages() == 0;
+#else
+    return false;
+#endif
+}
+
+std::size_t temp_int_file::resident_pages() const {
+#ifdef __linux__
+    void* mapping = mmap(nullptr, bytes, PROT_READ, MAP_SHARED, fd, 0);
+    if (mapping == MAP_FAILED){
+        throw std::runtime_error("mmap failed");
+    }
+    std::vector<unsigned char> residency((bytes + page_size() - 1) / page_size());
+    auto status = mincore(mapping, bytes, residency.data());
+    munmap(mapping, bytes);
+    if (status != 0){
+        throw std::runtime_error("mincore failed");
+    }
+    return std::count_if(begin(residency), end(residency), [](unsigned char page){ return page & 1; });
+#else
+    throw std::runtime_error("mincore is not available");
+#endif
+}
+
+std::size_t page_size(){
+    static const std::size_t size = static_cast<std::size_t>(sysconf(_SC_PAGESIZE));
+    return size;
+}
+
+std::vector<std::size_t> shuffled_pages(const temp_int_file& file, std::size_t seed){
+    std::vector<std::size_t> pages((file.size() + page_size() - 1) / page_size());
+    std::iota(begin(pages), end(pages), std::size_t(0));
+    std::shuffle(begin(pages), end(pages), std::mt19937_64(seed));
+    return pages;
+}
+
+std::uint32_t sum_mapped(const temp_int_file& file, const std::vector<std::size_t>& pages, page_advice advice, bool populate){
+    int flags = MAP_PRIVATE;
+#ifdef MAP_POPULATE
+    if (populate){
+        flags |= MAP_POPULATE;
+    }
+#else
+    (void)populate;
+#endif
+    void* mapping = mmap(nullptr, file.size(), PROT_READ, flags, file.descriptor(), 0);
+    if (mapping == MAP_FAILED){
+        throw std::runtime_error("mmap failed");
+    }
+    madvise(mapping, file.size(), to_madvise(advice));
+
+    auto data = static_cast<const char*>(mapping);
+    std::uint32_t sum = 0;
+    for (auto page : pages){
+        auto offset = page * page_size();
+        sum += sum_ints(data + offset, std::min(page_size(), file.size() - offset));
+    }
+
+    munmap(mapping, file.size());
+    return sum;
+}
+
+std::uint32_t sum_read_sequential(const temp_int_file& file, std::size_t buffer_bytes){
+    std::vector<char> buffer(buffer_bytes);
+    std::uint32_t sum = 0;
+    for (std::size_t offset = 0; offset < file.size(); offset += buffer_bytes){
+        auto count = std::min(buffer_bytes, file.size() - offset);
+        read_fully(file.descriptor(), buffer.data(), count, offset);
+        sum += sum_ints(buffer.data(), count);
+    }
+    return sum;
+}
+
+std::uint32_t sum_read_pages(const temp_int_file& file, const std::vector<std::size_t>& pages){
+    std::vector<char> buffer(page_size());
+    std::uint32_t sum = 0;
+    for (auto page : pages){
+        auto offset = page * page_size();
+        auto count = std::min(page_size(), file.size() - offset);
+        read_fully(file.descriptor(), buffer.data(), count, offset);
+        sum += sum_ints(buffer.data(), count);
+    }
+    return sum;
+}
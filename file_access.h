@@ -0,0 +1,78 @@
+#pragma once
+#ifndef WTF_FILE_ACCESS
+#define WTF_FILE_ACCESS
+
+#include <cstdint>
+#include <cstddef>
+#include <string>
+#include <vector>
+
+/* Temporary file holding an int array, removed again on destruction.
+ *
+ * Created in $TMPDIR, or /tmp if that is not set. The contents are synced to disk right after writing,
+ * so that drop_cache can later evict them from the page cache.
+ * TMPDIR has to be on a filesystem backed by a block device for that. On tmpfs, which /tmp often is,
+ * the page cache is the only copy of the file and it cannot be evicted.
+ */
+class temp_int_file {
+public:
+    explicit temp_int_file(const std::vector<int>& contents);
+    ~temp_int_file();
+
+    temp_int_file(const temp_int_file&) = delete;
+    temp_int_file& operator=(const temp_int_file&) = delete;
+
+    int descriptor() const {
+        return fd;
+    }
+
+    std::size_t size() const {
+        return bytes;
+    }
+
+    /* Asks the kernel to evict the file from the page cache, with POSIX_FADV_DONTNEED.
+     *
+     * The kernel is free to ignore it, and it cannot drop caches below the filesystem (disk, hypervisor).
+     *
+     *
+     * Returns true if no page of the file is resident afterwards. False if the advice failed, pages stayed resident,
+     * or either eviction or the residency check is not available on this platform.
+     */
+    bool drop_cache() const;
+
+    //Returns number of the file's pages in the page cache, as reported by mincore. Throws where mincore is not available.
+    std::size_t resident_pages() const;
+
+private:
+    std::string path;
+    int fd = -1;
+    std::size_t bytes = 0;
+};
+
+//Access pattern hints for a mapping, passed on as the madvise advice of the same name.
+enum class page_advice {
+    normal,
+    sequential,
+    random,
+    willneed
+};
+
+std::size_t page_size();
+
+//Indices of all the pages of file, in random order.
+std::vector<std::size_t> shuffled_pages(const temp_int_file& file, std::size_t seed = 0);
+
+/* Sums the ints of file through mmap, page by page in given order.
+ *
+ * Mapping and unmapping are part of the work. advice is given for the whole mapping
+ * and populate asks for the mapping to be prefaulted, where MAP_POPULATE is available.
+ */
+std::uint32_t sum_mapped(const temp_int_file& file, const std::vector<std::size_t>& pages, page_advice advice, bool populate);
+
+//Sums the ints of file sequentially, reading it with pread into a buffer of buffer_bytes.
+std::uint32_t sum_read_sequential(const temp_int_file& file, std::size_t buffer_bytes);
+
+//Sums the ints of file, reading it with pread one page at a time in given order.
+std::uint32_t sum_read_pages(const temp_int_file& file, const std::vector<std::size_t>& pages);
+
+#endif
@@ -29,9 +29,9 @@ public:
     :flatmap(std::begin(elems), std::end(elems)){}
 
     std::pair<iterator, bool> insert(const value_type& elem){
-        //find + insert
-        auto it = find(elem.first);
-        if (it != std::end(data)){
+        //lower_bound + insert, so that the data stays sorted
+        auto it = lower_bound(elem.first);
+        if (it != std::end(data) && it->first == elem.first){
             return {it, false};
         } else {
             return {insert(it, elem), true};
@@ -52,6 +52,19 @@ public:
         }
     }
 
+    iterator lower_bound(const key_type& key){
+        return std::lower_bound(std::begin(data), std::end(data), key, [](const value_type& val, const key_type& key) {return val.first < key;} );
+    }
+
+    const_iterator find(const key_type& key) const {
+        auto it = std::lower_bound(std::begin(data), std::end(data), key, [](const value_type& val, const key_type& key) {return val.first < key;} );
+        if (it != std::end(data) && it->first == key){
+            return it;
+        } else {
+            return std::end(data);
+        }
+    }
+
     value_type& operator[](const key_type& key){
         auto it = find(key);
         if (it == end(data)){
@@ -0,0 +1,75 @@
+#pragma once
+#ifndef WTF_FRONT_CACHE
+#define WTF_FRONT_CACHE
+
+#include <array>
+#include <cstdint>
+#include <utility>
+
+#include "utilities.h"
+
+/* Small direct mapped cache of lookup results, in front of any map-like Container.
+ *
+ * Cached iterators are dropped on every insertion, because flatmap invalidates them.
+ * That is done by bumping a generation counter, so inserting stays O(1) on top of the Container.
+ */
+template <typename Container, std::size_t Slots = 64>
+class front_cached {
+    static_assert(is_power_of_2(Slots), "Slots must be a power of two.");
+
+public:
+    using iterator = typename Container::iterator;
+    using value_type = typename Container::value_type;
+    using mapped_type = typename Container::mapped_type;
+    using key_type = typename Container::key_type;
+
+    iterator find(const key_type& key){
+        auto& cached = slots[slot_of(key)];
+        if (cached.generation == generation && cached.key == key){
+            return cached.position;
+        }
+        auto it = data.find(key);
+        if (it != data.end()){
+            cached.key = key;
+            cached.position = it;
+            cached.generation = generation;
+        }
+        return it;
+    }
+
+    std::pair<iterator, bool> insert(const value_type& elem){
+        ++generation;
+        return data.insert(elem);
+    }
+
+    iterator insert(iterator position, const value_type& elem){
+        ++generation;
+        return data.insert(position, elem);
+    }
+
+    iterator begin(){
+        return data.begin();
+    }
+
+    iterator end(){
+        return data.end();
+    }
+
+private:
+    //Fibonacci hashing, keys in benchmarks are sequential, so their low bits alone would be poorly distributed.
+    static std::size_t slot_of(const key_type& key){
+        return (static_cast<std::uint32_t>(key) * 2654435769u >> 16) & (Slots - 1);
+    }
+
+    struct slot {
+        key_type key{};
+        iterator position{};
+        std::uint64_t generation = 0;
+    };
+
+    Container data;
+    std::array<slot, Slots> slots;
+    std::uint64_t generation = 1;
+};
+
+#endif
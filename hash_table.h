@@ -0,0 +1,89 @@
+#pragma once
+#ifndef WTF_HASH_TABLE
+#define WTF_HASH_TABLE
+
+#include <vector>
+#include <cstdint>
+#include <algorithm>
+
+#include "utilities.h"
+
+//Finalizer of MurmurHash3, cheap and good enough to spread sequential keys.
+inline std::uint32_t hash_key(std::uint32_t key){
+    key ^= key >> 16;
+    key *= 0x85ebca6b;
+    key ^= key >> 13;
+    key *= 0xc2b2ae35;
+    key ^= key >> 16;
+    return key;
+}
+
+/* Open addressing hash map with linear probing, for unsigned integer keys.
+ *
+ * Sized up front for expected number of keys and never grows, so the caller has to know the key count.
+ * Uses the low bits of hash_key, so keys that were partitioned by the high bits still spread over the whole table.
+ */
+template <typename Key, typename Value>
+class linear_probing_map {
+public:
+    struct slot {
+        Key key;
+        Value value;
+        bool occupied;
+    };
+
+    explicit linear_probing_map(std::size_t expected)
+    :slots(upper_power_of_2(std::max<std::size_t>(expected * 2, 16))), mask(slots.size() - 1){}
+
+    //Returns the value for key, inserting a value-initialized one if the key is not present.
+    Value& operator[](const Key& key){
+        for (auto pos = hash_key(key) & mask; ; pos = (pos + 1) & mask){
+            auto& s = slots[pos];
+            if (!s.occupied){
+                s = slot{key, Value{}, true};
+                ++count;
+                return s.value;
+            }
+            if (s.key == key){
+                return s.value;
+            }
+        }
+    }
+
+    const Value* find(const Key& key) const {
+        for (auto pos = hash_key(key) & mask; ; pos = (pos + 1) & mask){
+            const auto& s = slots[pos];
+            if (!s.occupied){
+                return nullptr;
+            }
+            if (s.key == key){
+                return &s.value;
+            }
+        }
+    }
+
+    void clear(){
+        std::fill(begin(slots), end(slots), slot{});
+        count = 0;
+    }
+
+    std::size_t size() const {
+        return count;
+    }
+
+    //Raw slot access, for callers that drive the probing themselves, like interleaved lookups.
+    const slot* data() const {
+        return slots.data();
+    }
+
+    std::size_t bucket_mask() const {
+        return mask;
+    }
+
+private:
+    std::vector<slot> slots;
+    std::size_t mask;
+    std::size_t count = 0;
+};
+
+#endif
@@ -0,0 +1,89 @@
+#pragma once
+#ifndef WTF_KEY_DISTRIBUTIONS
+#define WTF_KEY_DISTRIBUTIONS
+
+#include <vector>
+#include <random>
+#include <numeric>
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+
+/* Distributions of indices into [0, n), used to pick which of n keys gets looked up.
+ *
+ * The skewed distributions assign popularity to a random permutation of indices,
+ * so that hot keys are not also neighbours in sorted containers.
+ */
+
+class uniform_keys {
+public:
+    explicit uniform_keys(std::size_t n)
+    :dist(0, n - 1){}
+
+    template <typename Generator>
+    std::size_t operator()(Generator& gen){
+        return dist(gen);
+    }
+
+private:
+    std::uniform_int_distribution<std::size_t> dist;
+};
+
+/* Zipf distribution, probability of k-th most popular key is proportional to 1 / k**exponent.
+ */
+class zipf_keys {
+public:
+    zipf_keys(std::size_t n, double exponent)
+    :ranks(shuffled_indices(n)), dist(make_distribution(n, exponent)){}
+
+    template <typename Generator>
+    std::size_t operator()(Generator& gen){
+        return ranks[dist(gen)];
+    }
+
+private:
+    static std::discrete_distribution<std::size_t> make_distribution(std::size_t n, double exponent){
+        std::vector<double> weights(n);
+        for (std::size_t k = 0; k < n; ++k){
+            weights[k] = 1.0 / std::pow(k + 1, exponent);
+        }
+        return std::discrete_distribution<std::size_t>(begin(weights), end(weights));
+    }
+
+    static std::vector<std::uint32_t> shuffled_indices(std::size_t n){
+        std::vector<std::uint32_t> temp(n);
+        std::iota(begin(temp), end(temp), 0);
+        std::shuffle(begin(temp), end(temp), std::mt19937_64(n));
+        return temp;
+    }
+
+    std::vector<std::uint32_t> ranks;
+    std::discrete_distribution<std::size_t> dist;
+};
+
+/* Hot set/cold set distribution, hot_fraction of keys receive hot_probability of lookups,
+ * keys within each set are picked uniformly.
+ */
+class hot_set_keys {
+public:
+    hot_set_keys(std::size_t n, double hot_fraction, double hot_probability)
+    :ranks(n), hot_size(std::max<std::size_t>(1, n * hot_fraction)), pick_hot(hot_probability),
+     hot(0, hot_size - 1), cold(std::min(hot_size, n - 1), n - 1){
+        std::iota(begin(ranks), end(ranks), 0);
+        std::shuffle(begin(ranks), end(ranks), std::mt19937_64(n));
+    }
+
+    template <typename Generator>
+    std::size_t operator()(Generator& gen){
+        return ranks[pick_hot(gen) ? hot(gen) : cold(gen)];
+    }
+
+private:
+    std::vector<std::uint32_t> ranks;
+    std::size_t hot_size;
+    std::bernoulli_distribution pick_hot;
+    std::uniform_int_distribution<std::size_t> hot;
+    std::uniform_int_distribution<std::size_t> cold;
+};
+
+#endif
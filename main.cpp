@@ -5,15 +5,29 @@
 #include <fstream>
 #include <cstdint>
 #include <list>
+#include <deque>
 #include <ostream>
 #include <map>
+#include <numeric>
+#include <random>
+#include <cmath>
+#include <string>
 
 #include "matrix_multiplication.h"
 #include "flatmap.h"
+#include "concurrent_maps.h"
+#include "front_cache.h"
+#include "bplustree.h"
+#include "unrolled_list.h"
+#include "aligned_allocator.h"
+#include "record_layouts.h"
+#include "roofline.h"
 #include "measuring_bench.h"
 #include "data_generation.h"
 #include "utilities.h"
 #include "min_LCG.h"
+#include "tracing.h"
+#include "noisy_neighbor.h"
 #include "cogs/types/counting_iterator.hpp"
 
 #include "benchmarks.hpp"
@@ -26,94 +40,626 @@ void print_results(std::ostream& out, const measurements& results){
     }
 }
 
+//Columns added by print_results, when it is given a work model.
+const char roofline_columns[] = ",\t\tns/element,\t\tGB/s,\t\tGops/s,\t\tOps/byte,\t\tMemory roof,\t\tRoofline %";
+
+/* Prints results, followed by metrics normalized by the work done in a single run.
+ *
+ * WorkModel maps the size in the first column to run_work.
+ * The memory roof is the cache level, or main memory, that the run's working set fits into.
+ */
+template <typename WorkModel>
+void print_results(std::ostream& out, const measurements& results, WorkModel model){
+    host_peaks(); //Get the measurement out of the way before printing any rows.
+    for (const auto& pair : results){
+        auto work = model(pair.first);
+        auto seconds = pair.second * 1e-9 / rep_count;
+        out << pair.first << ",\t\t" << pair.second
+            << ",\t\t" << pair.second / (rep_count * work.elements)
+            << ",\t\t" << work.bytes / seconds / 1e9
+            << ",\t\t" << work.ops / seconds / 1e9
+            << ",\t\t" << (work.bytes > 0 ? work.ops / work.bytes : 0)
+            << ",\t\t" << memory_roof_for(work).name
+            << ",\t\t" << 100 * roofline_fraction(work, seconds) << '\n';
+    }
+}
+
+//Columns added by print_results, when it is given footprints. Empty unless allocations are tracked.
+const char* const footprint_columns = allocation_tracking_enabled
+    ? ",\t\tElements,\t\tSetup allocations,\t\tSetup bytes,\t\tBytes/element,\t\tSetup peak bytes,\t\tTimed allocations,\t\tTimed bytes"
+    : "";
+
+/* Prints results, followed by space taken by the measured container.
+ *
+ * Bytes/element is what construction left allocated, divided by the number of elements.
+ * Without allocation tracking there is nothing to print, so this is the same as plain print_results.
+ */
+void print_results(std::ostream& out, const measurements& results, const footprints& space){
+    if (!allocation_tracking_enabled){
+        print_results(out, results);
+        return;
+    }
+    for (std::size_t i = 0; i < results.size(); ++i){
+        const auto& fp = space[i].second;
+        out << results[i].first << ",\t\t" << results[i].second
+            << ",\t\t" << fp.elements
+            << ",\t\t" << fp.setup.count
+            << ",\t\t" << fp.setup.bytes
+            << ",\t\t" << static_cast<double>(fp.setup.retained) / std::max<std::size_t>(fp.elements, 1)
+            << ",\t\t" << fp.setup.peak
+            << ",\t\t" << fp.timed.count
+            << ",\t\t" << fp.timed.bytes << '\n';
+    }
+}
+
+/* Work models, for benchmarks whose work per run is simple to count.
+ */
+run_work sum_work(std::size_t n){
+    return {double(n), double(n * sizeof(int)), double(n), double(n * sizeof(int)), op_type::i32};
+}
+
+//Stepping visits every step-th element of largest_sequence, but whole cache lines of it are brought in.
+run_work skip_work(std::size_t step){
+    auto visited = double(largest_sequence / step);
+    return {visited, visited * sizeof(int), visited, double(largest_sequence * sizeof(int)), op_type::i32};
+}
+
+template <typename T>
+run_work multiply_work(std::size_t n){
+    auto elements = double(n) * n;
+    return {elements, 3 * elements * sizeof(T), 2 * elements * n, 3 * elements * sizeof(T), op_type_of<T>()};
+}
+
+run_work transpose_work(std::size_t n){
+    auto elements = double(n) * n;
+    return {elements, 2 * elements * sizeof(double), 0, 2 * elements * sizeof(double), op_type::f64};
+}
+
+//Every updated field is read and written, with a multiply and an add in between. Records always have 8 fields.
+template <std::size_t Fields>
+run_work layout_update_work(std::size_t n){
+    auto fields = double(n) * Fields;
+    return {double(n), 2 * fields * sizeof(float), 2 * fields, double(n) * 8 * sizeof(float), op_type::f32};
+}
+
+//Per sorted element, for grids that are already per element. Every key is read and written at least once,
+//and takes log2(n) comparisons. The working set is the input and the working copy.
+template <typename Key>
+run_work sort_work(std::size_t n){
+    return {1, 2.0 * sizeof(Key), std::log2(double(n)), 2.0 * n * sizeof(Key), op_type_of<Key>()};
+}
+
+//Every input pair is streamed once and adds its value into one slot of a table for the distinct keys.
+run_work aggregation_work(std::size_t distinct){
+    using slot_type = aggregation_table::slot;
+    auto pairs = double(aggregation_pairs);
+    auto table = double(upper_power_of_2(std::max<std::size_t>(distinct * 2, 16)) * sizeof(slot_type));
+    return {pairs, pairs * (sizeof(aggregation_input::value_type) + sizeof(slot_type)), pairs, table, op_type::i32};
+}
+
+//Binary search touches log2(n) elements per lookup, with a comparison for each of them.
+template <typename Element>
+run_work binary_search_lookup_work(std::size_t n){
+    auto lookups = double(interleaved_lookup_count);
+    auto steps = std::max(std::log2(double(n)), 1.0);
+    return {lookups, lookups * steps * sizeof(Element), lookups * steps, double(n * sizeof(Element)), op_type::i32};
+}
+
+//Hash lookup of an existing key usually reads its home slot only. The table has 2n slots, rounded up to a power of two.
+run_work hash_lookup_work(std::size_t n){
+    using slot_type = linear_probing_map<int, int>::slot;
+    auto lookups = double(interleaved_lookup_count);
+    auto table = double(upper_power_of_2(std::max<std::size_t>(n * 2, 16)) * sizeof(slot_type));
+    return {lookups, lookups * sizeof(slot_type), lookups, table, op_type::i32};
+}
+
+template <typename Value>
+void print_grid(std::ostream& out, const basic_grid<Value>& results){
+    for (const auto& row : results){
+        out << row.first;
+        for (const auto& value : row.second){
+            out << ",\t\t" << value;
+        }
+        out << '\n';
+    }
+}
+
+//Header for print_grid with a work model, the grid's own columns followed by the memory roof and roofline % of each of them.
+void print_roofline_grid_header(std::ostream& out, const char* first, const std::vector<std::string>& columns){
+    out << first;
+    for (const auto& column : columns){
+        out << ",\t\t" << column;
+    }
+    out << ",\t\tMemory roof";
+    for (const auto& column : columns){
+        out << ",\t\t" << column << " roofline %";
+    }
+    out << '\n';
+}
+
+/* Prints grid, followed by the memory roof and the fraction of the roofline reached by every column.
+ *
+ * WorkModel maps the size in the first column to run_work, values are ns taken by given number of runs.
+ */
+template <typename Value, typename WorkModel>
+void print_grid(std::ostream& out, const basic_grid<Value>& results, WorkModel model, double runs){
+    host_peaks(); //Get the measurement out of the way before printing any rows.
+    for (const auto& row : results){
+        auto work = model(row.first);
+        out << row.first;
+        for (const auto& value : row.second){
+            out << ",\t\t" << value;
+        }
+        out << ",\t\t" << memory_roof_for(work).name;
+        for (const auto& value : row.second){
+            out << ",\t\t" << 100 * roofline_fraction(work, value * 1e-9 / runs);
+        }
+        out << '\n';
+    }
+}
+
 void sequential_sum_vector(std::ostream& out){
     auto results = measure_iteration<std::vector<int>>(smallest_sequence, largest_sequence);
-    out << "N,\t\tVector\n";
-    print_results(out, results);
+    out << "N,\t\tVector" << roofline_columns << '\n';
+    print_results(out, results, sum_work);
 }
 
 void sequential_sum_list(std::ostream& out){
     auto results = measure_iteration<std::list<int>>(smallest_sequence, largest_sequence);
-    out << "N,\t\tList\n";
+    out << "N,\t\tList" << roofline_columns << '\n';
+    print_results(out, results, sum_work);
+}
+
+void sequential_sum_deque(std::ostream& out){
+    auto results = measure_iteration<std::deque<int>>(smallest_sequence, largest_sequence);
+    out << "N,\t\tDeque" << roofline_columns << '\n';
+    print_results(out, results, sum_work);
+}
+
+void sequential_sum_unrolled_list(std::ostream& out){
+    auto results = measure_iteration<unrolled_list<int>>(smallest_sequence, largest_sequence);
+    out << "N,\t\tUnrolled List" << roofline_columns << '\n';
+    print_results(out, results, sum_work);
+}
+
+void sequential_sum_unrolled_list_4lines(std::ostream& out){
+    auto results = measure_iteration<unrolled_list<int, 4 * cache_line_size>>(smallest_sequence, largest_sequence);
+    out << "N,\t\tUnrolled List (4 lines)" << roofline_columns << '\n';
+    print_results(out, results, sum_work);
+}
+
+void reverse_sum_deque(std::ostream& out){
+    auto results = measure_reversed_iteration<std::deque<int>>(smallest_sequence, largest_sequence);
+    out << "N,\t\tReverse Deque" << roofline_columns << '\n';
+    print_results(out, results, sum_work);
+}
+
+void reverse_sum_unrolled_list(std::ostream& out){
+    auto results = measure_reversed_iteration<unrolled_list<int>>(smallest_sequence, largest_sequence);
+    out << "N,\t\tReverse Unrolled List" << roofline_columns << '\n';
+    print_results(out, results, sum_work);
+}
+
+void reverse_sum_unrolled_list_4lines(std::ostream& out){
+    auto results = measure_reversed_iteration<unrolled_list<int, 4 * cache_line_size>>(smallest_sequence, largest_sequence);
+    out << "N,\t\tReverse Unrolled List (4 lines)" << roofline_columns << '\n';
+    print_results(out, results, sum_work);
+}
+
+void middle_insert_vector(std::ostream& out){
+    auto results = measure_middle_insertion<std::vector<int>>(smallest_sequence, largest_insertion_sequence);
+    out << "N,\t\tMiddle Insertion Vector\n";
+    print_results(out, results);
+}
+
+void middle_insert_list(std::ostream& out){
+    auto results = measure_middle_insertion<std::list<int>>(smallest_sequence, largest_insertion_sequence);
+    out << "N,\t\tMiddle Insertion List\n";
+    print_results(out, results);
+}
+
+void middle_insert_deque(std::ostream& out){
+    auto results = measure_middle_insertion<std::deque<int>>(smallest_sequence, largest_insertion_sequence);
+    out << "N,\t\tMiddle Insertion Deque\n";
+    print_results(out, results);
+}
+
+void middle_insert_unrolled_list(std::ostream& out){
+    auto results = measure_middle_insertion<unrolled_list<int>>(smallest_sequence, largest_insertion_sequence);
+    out << "N,\t\tMiddle Insertion Unrolled List\n";
+    print_results(out, results);
+}
+
+void middle_insert_unrolled_list_4lines(std::ostream& out){
+    auto results = measure_middle_insertion<unrolled_list<int, 4 * cache_line_size>>(smallest_sequence, largest_insertion_sequence);
+    out << "N,\t\tMiddle Insertion Unrolled List (4 lines)\n";
     print_results(out, results);
 }
 
 void naive_matrix_multiply(std::ostream& out){
     auto results = measure_matrix_multiplication(smallest_matrix, largest_matrix, multiply_naive);
-    out << "N,\t\tNaive\n";
-    print_results(out, results);
+    out << "N,\t\tNaive" << roofline_columns << '\n';
+    print_results(out, results, multiply_work<double>);
 }
 
 void smarter_matrix_multiply(std::ostream& out){
     auto results = measure_matrix_multiplication(smallest_matrix, largest_matrix, multiply_smarter);
-    out << "N,\t\tSmarter\n";
-    print_results(out, results);
+    out << "N,\t\tSmarter" << roofline_columns << '\n';
+    print_results(out, results, multiply_work<double>);
+}
+
+void naive_matrix_multiply_padded(std::ostream& out){
+    auto results = measure_matrix_multiplication(smallest_matrix, largest_matrix, multiply_naive, matrix_padding);
+    out << "N,\t\tNaive (padded)" << roofline_columns << '\n';
+    print_results(out, results, multiply_work<double>);
+}
+
+void smarter_matrix_multiply_padded(std::ostream& out){
+    auto results = measure_matrix_multiplication(smallest_matrix, largest_matrix, multiply_smarter, matrix_padding);
+    out << "N,\t\tSmarter (padded)" << roofline_columns << '\n';
+    print_results(out, results, multiply_work<double>);
+}
+
+void naive_matrix_transpose(std::ostream& out){
+    auto results = measure_matrix_transpose(smallest_matrix, largest_matrix, transpose_naive);
+    out << "N,\t\tNaive Transpose" << roofline_columns << '\n';
+    print_results(out, results, transpose_work);
+}
+
+void naive_matrix_transpose_padded(std::ostream& out){
+    auto results = measure_matrix_transpose(smallest_matrix, largest_matrix, transpose_naive, matrix_padding);
+    out << "N,\t\tNaive Transpose (padded)" << roofline_columns << '\n';
+    print_results(out, results, transpose_work);
+}
+
+void blocked_matrix_transpose(std::ostream& out){
+    auto results = measure_matrix_transpose(smallest_matrix, largest_matrix, transpose_blocked);
+    out << "N,\t\tBlocked Transpose" << roofline_columns << '\n';
+    print_results(out, results, transpose_work);
+}
+
+void blocked_matrix_transpose_padded(std::ostream& out){
+    auto results = measure_matrix_transpose(smallest_matrix, largest_matrix, transpose_blocked, matrix_padding);
+    out << "N,\t\tBlocked Transpose (padded)" << roofline_columns << '\n';
+    print_results(out, results, transpose_work);
+}
+
+void recursive_matrix_transpose(std::ostream& out){
+    auto results = measure_matrix_transpose(smallest_matrix, largest_matrix, transpose_recursive);
+    out << "N,\t\tRecursive Transpose" << roofline_columns << '\n';
+    print_results(out, results, transpose_work);
+}
+
+void recursive_matrix_transpose_padded(std::ostream& out){
+    auto results = measure_matrix_transpose(smallest_matrix, largest_matrix, transpose_recursive, matrix_padding);
+    out << "N,\t\tRecursive Transpose (padded)" << roofline_columns << '\n';
+    print_results(out, results, transpose_work);
 }
 
 void reverse_sum_vector(std::ostream& out){
     auto results = measure_reversed_iteration<std::vector<int>>(smallest_sequence, largest_sequence);
-    out << "N,\t\tReverse Vector\n";
-    print_results(out, results);
+    out << "N,\t\tReverse Vector" << roofline_columns << '\n';
+    print_results(out, results, sum_work);
 }
 
 void reverse_sum_list(std::ostream& out) {
     auto results = measure_reversed_iteration<std::list<int>>(smallest_sequence, largest_sequence);
-    out << "N,\t\tReverse List\n";
-    print_results(out, results);
+    out << "N,\t\tReverse List" << roofline_columns << '\n';
+    print_results(out, results, sum_work);
 }
 
 void vector_element_skip(std::ostream& out){
     auto results = measure_vector_skip(smallest_step, largest_step);
-    out << "N,\t\tVector Stepping\n";
-    print_results(out, results);
+    out << "N,\t\tVector Stepping" << roofline_columns << '\n';
+    print_results(out, results, skip_work);
 }
 
 void random_sum_vector(std::ostream& out){
     auto results = measure_random_iteration(smallest_sequence, largest_sequence);
-    out << "N,\t\tRandom Iteration\n";
+    out << "N,\t\tRandom Iteration" << roofline_columns << '\n';
+    print_results(out, results, sum_work);
+}
+
+void sequential_access_modes(std::ostream& out){
+    auto results = merge_columns({
+        measure_sequential_access<access_mode::read>(smallest_sequence, largest_sequence),
+        measure_sequential_access<access_mode::write>(smallest_sequence, largest_sequence),
+        measure_sequential_access<access_mode::read_modify_write>(smallest_sequence, largest_sequence),
+        measure_sequential_access<access_mode::streaming_store>(smallest_sequence, largest_sequence)
+    });
+    out << "N,\t\tRead,\t\tWrite,\t\tRead-modify-write,\t\tStreaming store\n";
+    print_grid(out, results);
+}
+
+void strided_access_modes(std::ostream& out){
+    auto results = merge_columns({
+        measure_vector_skip<access_mode::read>(smallest_step, largest_step),
+        measure_vector_skip<access_mode::write>(smallest_step, largest_step),
+        measure_vector_skip<access_mode::read_modify_write>(smallest_step, largest_step),
+        measure_vector_skip<access_mode::streaming_store>(smallest_step, largest_step)
+    });
+    out << "Step,\t\tRead,\t\tWrite,\t\tRead-modify-write,\t\tStreaming store\n";
+    print_grid(out, results);
+}
+
+void random_access_modes(std::ostream& out){
+    auto results = merge_columns({
+        measure_random_iteration<access_mode::read>(smallest_sequence, largest_sequence),
+        measure_random_iteration<access_mode::write>(smallest_sequence, largest_sequence),
+        measure_random_iteration<access_mode::read_modify_write>(smallest_sequence, largest_sequence),
+        measure_random_iteration<access_mode::streaming_store>(smallest_sequence, largest_sequence)
+    });
+    out << "N,\t\tRead,\t\tWrite,\t\tRead-modify-write,\t\tStreaming store\n";
+    print_grid(out, results);
+}
+
+void stride_capacity(std::ostream& out){
+    auto results = measure_stride_capacity(smallest_chase, largest_chase);
+    out << "Stride \\ Lines";
+    for (auto lines = smallest_chase; lines <= largest_chase; lines *= 2){
+        out << ",\t\t" << lines;
+    }
+    out << '\n';
+    print_grid(out, results);
+}
+
+void store_load_aliasing(std::ostream& out){
+    auto results = measure_4k_aliasing(0, 4096, 16);
+    out << "Offset,\t\t4K Aliasing\n";
     print_results(out, results);
 }
 
 void read_map(std::ostream& out){
-    auto results = measure_random_access<std::map<int, BFPOD>, 1, 0>(smallest_map, largest_map);
-    out << "N,\t\tRead Map (1 : 0 (read only))\n";
-    print_results(out, results);
+    footprints space;
+    auto results = measure_random_access<std::map<int, BFPOD>, 1, 0>(smallest_map, largest_map, &space);
+    out << "N,\t\tRead Map (1 : 0 (read only))" << footprint_columns << '\n';
+    print_results(out, results, space);
 }
 void read_write_map(std::ostream& out){
-    auto results = measure_random_access<std::map<int, BFPOD>, 1, 1>(smallest_map, largest_map);
-    out << "N,\t\tRead Map (1 : 1 (read, write))\n";
-    print_results(out, results);
+    footprints space;
+    auto results = measure_random_access<std::map<int, BFPOD>, 1, 1>(smallest_map, largest_map, &space);
+    out << "N,\t\tRead Map (1 : 1 (read, write))" << footprint_columns << '\n';
+    print_results(out, results, space);
 }
 void read_heavy_map(std::ostream& out){
-    auto results = measure_random_access<std::map<int, BFPOD>, 15, 1>(smallest_map, largest_map);
-    out << "N,\t\tRead Map (15 : 1 (read heavy))\n";
-    print_results(out, results);
+    footprints space;
+    auto results = measure_random_access<std::map<int, BFPOD>, 15, 1>(smallest_map, largest_map, &space);
+    out << "N,\t\tRead Map (15 : 1 (read heavy))" << footprint_columns << '\n';
+    print_results(out, results, space);
 }
 void read_flatmap(std::ostream& out){
-    auto results = measure_random_access<flatmap<int, BFPOD>, 1, 0>(smallest_map, largest_map);
-    out << "N,\t\tRead Flatmap (1 : 0 (read only))\n";
-    print_results(out, results);
+    footprints space;
+    auto results = measure_random_access<flatmap<int, BFPOD>, 1, 0>(smallest_map, largest_map, &space);
+    out << "N,\t\tRead Flatmap (1 : 0 (read only))" << footprint_columns << '\n';
+    print_results(out, results, space);
 }
 void read_write_flatmap(std::ostream& out){
-    auto results = measure_random_access<flatmap<int, BFPOD>, 1, 1>(smallest_map, largest_map);
-    out << "N,\t\tRead Flatmap (1 : 1 (read, write))\n";
-    print_results(out, results);
+    footprints space;
+    auto results = measure_random_access<flatmap<int, BFPOD>, 1, 1>(smallest_map, largest_map, &space);
+    out << "N,\t\tRead Flatmap (1 : 1 (read, write))" << footprint_columns << '\n';
+    print_results(out, results, space);
 }
 void read_heavy_flatmap(std::ostream& out){
-    auto results = measure_random_access<flatmap<int, BFPOD>, 15, 1>(smallest_map, largest_map);
-    out << "N,\t\tRead Flatmap (15 : 1 (read heavy))\n";
+    footprints space;
+    auto results = measure_random_access<flatmap<int, BFPOD>, 15, 1>(smallest_map, largest_map, &space);
+    out << "N,\t\tRead Flatmap (15 : 1 (read heavy))" << footprint_columns << '\n';
+    print_results(out, results, space);
+}
+
+std::size_t max_reader_threads(){
+    return std::max(std::thread::hardware_concurrency(), 1u);
+}
+
+void print_write_rates(std::ostream& out){
+    for (auto rate : concurrent_write_rates){
+        out << ",\t\t" << rate;
+    }
+    out << '\n';
+}
+
+void concurrent_read_map(std::ostream& out){
+    auto results = measure_concurrent_reads<locked_map<int, int>>(max_reader_threads());
+    out << "Map behind shared mutex: lookups/s, Readers \\ Writes/s";
+    print_write_rates(out);
+    print_grid(out, results);
+}
+void concurrent_read_rcu_flatmap(std::ostream& out){
+    auto results = measure_concurrent_reads<rcu_flatmap<int, int>>(max_reader_threads());
+    out << "RCU Flatmap: lookups/s, Readers \\ Writes/s";
+    print_write_rates(out);
+    print_grid(out, results);
+}
+void concurrent_read_seqlock_flatmap(std::ostream& out){
+    auto results = measure_concurrent_reads<seqlock_flatmap<int, int>>(max_reader_threads());
+    out << "Seqlock Flatmap: lookups/s, Readers \\ Writes/s";
+    print_write_rates(out);
+    print_grid(out, results);
+}
+
+template <typename Value>
+using int_map = std::map<int, Value>;
+template <typename Value>
+using int_flatmap = flatmap<int, Value>;
+
+void print_payload_sizes(std::ostream& out){
+    out << "N \\ Payload,\t\t8,\t\t64,\t\t512,\t\t4096\n";
+}
+
+void read_map_payloads(std::ostream& out){
+    auto results = measure_random_access_payloads<int_map, 1, 0, 8, 64, 512, 4096>(smallest_map, largest_map);
+    out << "Read Map (1 : 0 (read only))\n";
+    print_payload_sizes(out);
+    print_grid(out, results);
+}
+void read_flatmap_payloads(std::ostream& out){
+    auto results = measure_random_access_payloads<int_flatmap, 1, 0, 8, 64, 512, 4096>(smallest_map, largest_map);
+    out << "Read Flatmap (1 : 0 (read only))\n";
+    print_payload_sizes(out);
+    print_grid(out, results);
+}
+void read_write_map_payloads(std::ostream& out){
+    auto results = measure_random_access_payloads<int_map, 1, 1, 8, 64, 512, 4096>(smallest_map, largest_map);
+    out << "Read Map (1 : 1 (read, write))\n";
+    print_payload_sizes(out);
+    print_grid(out, results);
+}
+void read_write_flatmap_payloads(std::ostream& out){
+    auto results = measure_random_access_payloads<int_flatmap, 1, 1, 8, 64, 512, 4096>(smallest_map, largest_map);
+    out << "Read Flatmap (1 : 1 (read, write))\n";
+    print_payload_sizes(out);
+    print_grid(out, results);
+}
+void read_heavy_map_payloads(std::ostream& out){
+    auto results = measure_random_access_payloads<int_map, 15, 1, 8, 64, 512, 4096>(smallest_map, largest_map);
+    out << "Read Map (15 : 1 (read heavy))\n";
+    print_payload_sizes(out);
+    print_grid(out, results);
+}
+void read_heavy_flatmap_payloads(std::ostream& out){
+    auto results = measure_random_access_payloads<int_flatmap, 15, 1, 8, 64, 512, 4096>(smallest_map, largest_map);
+    out << "Read Flatmap (15 : 1 (read heavy))\n";
+    print_payload_sizes(out);
+    print_grid(out, results);
+}
+void write_map_payloads(std::ostream& out){
+    auto results = measure_write_payloads<int_map, 8, 64, 512, 4096>();
+    out << "Write Map\n";
+    print_payload_sizes(out);
+    print_grid(out, results);
+}
+void write_flatmap_payloads(std::ostream& out){
+    auto results = measure_write_payloads<int_flatmap, 8, 64, 512, 4096>();
+    out << "Write Flatmap\n";
+    print_payload_sizes(out);
+    print_grid(out, results);
+}
+
+void print_key_distributions(std::ostream& out){
+    out << "N,\t\tUniform,\t\tZipf (" << zipf_exponent << "),\t\tHot set ("
+        << hot_key_fraction << " : " << hot_key_probability << ")\n";
+}
+
+void skewed_read_map(std::ostream& out){
+    auto results = measure_key_distributions<std::map<int, BFPOD>>(smallest_map, largest_map);
+    out << "Read Map (key distributions)\n";
+    print_key_distributions(out);
+    print_grid(out, results);
+}
+void skewed_read_flatmap(std::ostream& out){
+    auto results = measure_key_distributions<flatmap<int, BFPOD>>(smallest_map, largest_map);
+    out << "Read Flatmap (key distributions)\n";
+    print_key_distributions(out);
+    print_grid(out, results);
+}
+void skewed_read_cached_map(std::ostream& out){
+    auto results = measure_key_distributions<front_cached<std::map<int, BFPOD>>>(smallest_map, largest_map);
+    out << "Read Front Cached Map (key distributions)\n";
+    print_key_distributions(out);
+    print_grid(out, results);
+}
+void skewed_read_cached_flatmap(std::ostream& out){
+    auto results = measure_key_distributions<front_cached<flatmap<int, BFPOD>>>(smallest_map, largest_map);
+    out << "Read Front Cached Flatmap (key distributions)\n";
+    print_key_distributions(out);
+    print_grid(out, results);
+}
+
+void print_hit_percentages(std::ostream& out){
+    out << "N \\ Hit %";
+    for (auto hit_percent : lookup_hit_percentages){
+        out << ",\t\t" << hit_percent;
+    }
+    out << '\n';
+}
+
+void miss_read_map(std::ostream& out){
+    auto results = measure_hit_ratios<std::map<int, BFPOD>>(smallest_map, largest_map);
+    out << "Read Map (hit ratios)\n";
+    print_hit_percentages(out);
+    print_grid(out, results);
+}
+void miss_read_flatmap(std::ostream& out){
+    auto results = measure_hit_ratios<flatmap<int, BFPOD>>(smallest_map, largest_map);
+    out << "Read Flatmap (hit ratios)\n";
+    print_hit_percentages(out);
+    print_grid(out, results);
+}
+void miss_read_bloom_map(std::ostream& out){
+    auto results = measure_hit_ratios<bloom_fronted<std::map<int, BFPOD>>>(smallest_map, largest_map);
+    out << "Read Bloom Filtered Map (hit ratios)\n";
+    print_hit_percentages(out);
+    print_grid(out, results);
+}
+void miss_read_bloom_flatmap(std::ostream& out){
+    auto results = measure_hit_ratios<bloom_fronted<flatmap<int, BFPOD>>>(smallest_map, largest_map);
+    out << "Read Bloom Filtered Flatmap (hit ratios)\n";
+    print_hit_percentages(out);
+    print_grid(out, results);
+}
+
+void read_btree(std::ostream& out){
+    footprints space;
+    auto results = measure_random_access<bplustree<int, BFPOD>, 1, 0>(smallest_map, largest_map, &space);
+    out << "N,\t\tRead B+tree (1 : 0 (read only))" << footprint_columns << '\n';
+    print_results(out, results, space);
+}
+void read_write_btree(std::ostream& out){
+    footprints space;
+    auto results = measure_random_access<bplustree<int, BFPOD>, 1, 1>(smallest_map, largest_map, &space);
+    out << "N,\t\tRead B+tree (1 : 1 (read, write))" << footprint_columns << '\n';
+    print_results(out, results, space);
+}
+void read_heavy_btree(std::ostream& out){
+    footprints space;
+    auto results = measure_random_access<bplustree<int, BFPOD>, 15, 1>(smallest_map, largest_map, &space);
+    out << "N,\t\tRead B+tree (15 : 1 (read heavy))" << footprint_columns << '\n';
+    print_results(out, results, space);
+}
+void read_btree_node_sizes(std::ostream& out){
+    auto results = merge_columns({
+        measure_random_access<bplustree<int, BFPOD, 1>, 1, 0>(smallest_map, largest_map),
+        measure_random_access<bplustree<int, BFPOD, 2>, 1, 0>(smallest_map, largest_map),
+        measure_random_access<bplustree<int, BFPOD, 4>, 1, 0>(smallest_map, largest_map),
+        measure_random_access<bplustree<int, BFPOD, 8>, 1, 0>(smallest_map, largest_map),
+        measure_random_access<bplustree<int, BFPOD, 16>, 1, 0>(smallest_map, largest_map)
+    });
+    out << "Read B+tree (1 : 0 (read only))\n";
+    out << "N \\ Node lines,\t\t1,\t\t2,\t\t4,\t\t8,\t\t16\n";
+    print_grid(out, results);
+}
+void write_btree(std::ostream& out){
+    footprints space;
+    auto results = measure_write<bplustree<int, BFPOD>>(&space);
+    out << "N,\t\tWrite B+tree" << footprint_columns << '\n';
+    print_results(out, results, space);
+}
+void range_scan_map(std::ostream& out){
+    auto results = measure_range_scan<std::map<int, BFPOD>>(smallest_map, largest_map);
+    out << "N,\t\tRange Scan Map\n";
+    print_results(out, results);
+}
+void range_scan_flatmap(std::ostream& out){
+    auto results = measure_range_scan<flatmap<int, BFPOD>>(smallest_map, largest_map);
+    out << "N,\t\tRange Scan Flatmap\n";
+    print_results(out, results);
+}
+void range_scan_btree(std::ostream& out){
+    auto results = measure_range_scan<bplustree<int, BFPOD>>(smallest_map, largest_map);
+    out << "N,\t\tRange Scan B+tree\n";
     print_results(out, results);
 }
 
 void write_map(std::ostream& out){
-    auto results = measure_write<std::map<int, BFPOD>>();
-    out << "N,\t\tWrite Map\n";
-    print_results(out, results);
+    footprints space;
+    auto results = measure_write<std::map<int, BFPOD>>(&space);
+    out << "N,\t\tWrite Map" << footprint_columns << '\n';
+    print_results(out, results, space);
 }
 void write_flatmap(std::ostream& out){
-    auto results = measure_write<flatmap<int, BFPOD>>();
-    out << "N,\t\tWrite Flatmap\n";
-    print_results(out, results);
+    footprints space;
+    auto results = measure_write<flatmap<int, BFPOD>>(&space);
+    out << "N,\t\tWrite Flatmap" << footprint_columns << '\n';
+    print_results(out, results, space);
 }
 
 void polymorphic_vector(std::ostream& out){
@@ -127,6 +673,292 @@ void polymorphic_sequence(std::ostream& out){
     print_results(out, results);
 }
 
+void aos_update_1_fields(std::ostream& out){
+    auto results = measure_layout_update<aos_records, 1>(smallest_records, largest_records);
+    out << "N,\t\tAoS (1 of 8 fields)" << roofline_columns << '\n';
+    print_results(out, results, layout_update_work<1>);
+}
+void aos_update_3_fields(std::ostream& out){
+    auto results = measure_layout_update<aos_records, 3>(smallest_records, largest_records);
+    out << "N,\t\tAoS (3 of 8 fields)" << roofline_columns << '\n';
+    print_results(out, results, layout_update_work<3>);
+}
+void aos_update_8_fields(std::ostream& out){
+    auto results = measure_layout_update<aos_records, 8>(smallest_records, largest_records);
+    out << "N,\t\tAoS (8 of 8 fields)" << roofline_columns << '\n';
+    print_results(out, results, layout_update_work<8>);
+}
+void soa_update_1_fields(std::ostream& out){
+    auto results = measure_layout_update<soa_records, 1>(smallest_records, largest_records);
+    out << "N,\t\tSoA (1 of 8 fields)" << roofline_columns << '\n';
+    print_results(out, results, layout_update_work<1>);
+}
+void soa_update_3_fields(std::ostream& out){
+    auto results = measure_layout_update<soa_records, 3>(smallest_records, largest_records);
+    out << "N,\t\tSoA (3 of 8 fields)" << roofline_columns << '\n';
+    print_results(out, results, layout_update_work<3>);
+}
+void soa_update_8_fields(std::ostream& out){
+    auto results = measure_layout_update<soa_records, 8>(smallest_records, largest_records);
+    out << "N,\t\tSoA (8 of 8 fields)" << roofline_columns << '\n';
+    print_results(out, results, layout_update_work<8>);
+}
+void aosoa_update_1_fields(std::ostream& out){
+    auto results = measure_layout_update<aosoa_records, 1>(smallest_records, largest_records);
+    out << "N,\t\tAoSoA (1 of 8 fields)" << roofline_columns << '\n';
+    print_results(out, results, layout_update_work<1>);
+}
+void aosoa_update_3_fields(std::ostream& out){
+    auto results = measure_layout_update<aosoa_records, 3>(smallest_records, largest_records);
+    out << "N,\t\tAoSoA (3 of 8 fields)" << roofline_columns << '\n';
+    print_results(out, results, layout_update_work<3>);
+}
+void aosoa_update_8_fields(std::ostream& out){
+    auto results = measure_layout_update<aosoa_records, 8>(smallest_records, largest_records);
+    out << "N,\t\tAoSoA (8 of 8 fields)" << roofline_columns << '\n';
+    print_results(out, results, layout_update_work<8>);
+}
+
+
+template <typename T>
+struct element_name;
+
+template <>
+struct element_name<float> {
+    static const char* get(){ return "float"; }
+};
+
+template <>
+struct element_name<double> {
+    static const char* get(){ return "double"; }
+};
+
+template <>
+struct element_name<std::int32_t> {
+    static const char* get(){ return "int32"; }
+};
+
+template <typename T, char... Order>
+void ordered_matrix_multiply(std::ostream& out){
+    const char order[] = {Order..., '\0'};
+    auto results = measure_matrix_multiplication<T>(smallest_matrix, largest_matrix, multiply_ordered<T, Order...>);
+    out << "N,\t\t" << order << " (" << element_name<T>::get() << ")" << roofline_columns << '\n';
+    print_results(out, results, multiply_work<T>);
+}
+
+
+void print_sorters(std::ostream& out){
+    print_roofline_grid_header(out, "N", {"std::sort", "std::stable_sort", "LSD radix", "Blocked merge"});
+}
+
+void sort_u32_random(std::ostream& out){
+    auto results = measure_sorters<std::uint32_t>(smallest_sequence, largest_sort, sort_input::random);
+    out << "Sort u32 random (ns per element)\n";
+    print_sorters(out);
+    print_grid(out, results, sort_work<std::uint32_t>, 1);
+}
+void sort_u32_presorted(std::ostream& out){
+    auto results = measure_sorters<std::uint32_t>(smallest_sequence, largest_sort, sort_input::presorted);
+    out << "Sort u32 presorted (ns per element)\n";
+    print_sorters(out);
+    print_grid(out, results, sort_work<std::uint32_t>, 1);
+}
+void sort_u32_reversed(std::ostream& out){
+    auto results = measure_sorters<std::uint32_t>(smallest_sequence, largest_sort, sort_input::reversed);
+    out << "Sort u32 reversed (ns per element)\n";
+    print_sorters(out);
+    print_grid(out, results, sort_work<std::uint32_t>, 1);
+}
+void sort_u32_few_unique(std::ostream& out){
+    auto results = measure_sorters<std::uint32_t>(smallest_sequence, largest_sort, sort_input::few_unique);
+    out << "Sort u32 few unique (ns per element)\n";
+    print_sorters(out);
+    print_grid(out, results, sort_work<std::uint32_t>, 1);
+}
+void sort_u64_random(std::ostream& out){
+    auto results = measure_sorters<std::uint64_t>(smallest_sequence, largest_sort, sort_input::random);
+    out << "Sort u64 random (ns per element)\n";
+    print_sorters(out);
+    print_grid(out, results, sort_work<std::uint64_t>, 1);
+}
+void sort_u64_presorted(std::ostream& out){
+    auto results = measure_sorters<std::uint64_t>(smallest_sequence, largest_sort, sort_input::presorted);
+    out << "Sort u64 presorted (ns per element)\n";
+    print_sorters(out);
+    print_grid(out, results, sort_work<std::uint64_t>, 1);
+}
+void sort_u64_reversed(std::ostream& out){
+    auto results = measure_sorters<std::uint64_t>(smallest_sequence, largest_sort, sort_input::reversed);
+    out << "Sort u64 reversed (ns per element)\n";
+    print_sorters(out);
+    print_grid(out, results, sort_work<std::uint64_t>, 1);
+}
+void sort_u64_few_unique(std::ostream& out){
+    auto results = measure_sorters<std::uint64_t>(smallest_sequence, largest_sort, sort_input::few_unique);
+    out << "Sort u64 few unique (ns per element)\n";
+    print_sorters(out);
+    print_grid(out, results, sort_work<std::uint64_t>, 1);
+}
+
+void hash_aggregation(std::ostream& out){
+    auto results = measure_aggregation(smallest_distinct, largest_distinct);
+    print_roofline_grid_header(out, "Distinct keys", {"Global table", "Radix partitioned"});
+    print_grid(out, results, aggregation_work, rep_count);
+}
+
+void print_lookup_groups(std::ostream& out){
+    std::vector<std::string> columns{"Sequential"};
+    for (std::size_t group = 1; group <= max_lookup_group; group *= 2){
+        columns.push_back("Group of " + std::to_string(group));
+    }
+    print_roofline_grid_header(out, "N", columns);
+}
+
+void interleaved_lookup_sorted_array(std::ostream& out){
+    auto results = measure_interleaved_lookups<std::vector<int>>(smallest_interleaved, largest_interleaved);
+    out << "Interleaved lookups, sorted array\n";
+    print_lookup_groups(out);
+    print_grid(out, results, binary_search_lookup_work<int>, rep_count);
+}
+void interleaved_lookup_flatmap(std::ostream& out){
+    auto results = measure_interleaved_lookups<flatmap<int, int>>(smallest_interleaved, largest_interleaved);
+    out << "Interleaved lookups, flatmap\n";
+    print_lookup_groups(out);
+    print_grid(out, results, binary_search_lookup_work<std::pair<int, int>>, rep_count);
+}
+void interleaved_lookup_hash_map(std::ostream& out){
+    auto results = measure_interleaved_lookups<linear_probing_map<int, int>>(smallest_interleaved, largest_interleaved);
+    out << "Interleaved lookups, linear probing hash map\n";
+    print_lookup_groups(out);
+    print_grid(out, results, hash_lookup_work, rep_count);
+}
+
+void compressed_lookup_flatmap(std::ostream& out){
+    footprints space;
+    auto results = measure_compressed_lookups<flatmap<int, int>>(smallest_compressed_map, largest_compressed_map, space);
+    out << "N,\t\tLookups Flatmap" << footprint_columns << '\n';
+    print_results(out, results, space);
+}
+void compressed_lookup_delta8(std::ostream& out){
+    footprints space;
+    auto results = measure_compressed_lookups<compressed_flatmap<int, int, std::uint8_t>>(smallest_compressed_map, largest_compressed_map, space);
+    out << "N,\t\tLookups Compressed Flatmap (8 bit deltas)" << footprint_columns << '\n';
+    print_results(out, results, space);
+}
+void compressed_lookup_delta16(std::ostream& out){
+    footprints space;
+    auto results = measure_compressed_lookups<compressed_flatmap<int, int, std::uint16_t>>(smallest_compressed_map, largest_compressed_map, space);
+    out << "N,\t\tLookups Compressed Flatmap (16 bit deltas)" << footprint_columns << '\n';
+    print_results(out, results, space);
+}
+
+void print_file_methods(std::ostream& out, file_order order){
+    if (order == file_order::sequential){
+        out << "Bytes,\t\tmmap,\t\tmmap sequential,\t\tmmap willneed,\t\tmmap populate";
+        for (auto buffer_size : read_buffer_sizes){
+            out << ",\t\tpread " << buffer_size / 1024 << " KiB";
+        }
+        out << '\n';
+    } else {
+        out << "Bytes,\t\tmmap,\t\tmmap random,\t\tmmap populate,\t\tpread page\n";
+    }
+}
+
+void file_sequential_hot(std::ostream& out){
+    auto results = measure_file_access(smallest_file, largest_file, file_order::sequential, false);
+    out << "Sequential file sum, hot page cache\n";
+    print_file_methods(out, file_order::sequential);
+    print_grid(out, results);
+}
+void file_sequential_cold(std::ostream& out){
+    auto results = measure_file_access(smallest_file, largest_file, file_order::sequential, true);
+    out << "Sequential file sum, cold page cache\n";
+    print_file_methods(out, file_order::sequential);
+    print_grid(out, results);
+}
+void file_random_hot(std::ostream& out){
+    auto results = measure_file_access(smallest_file, largest_file, file_order::random, false);
+    out << "Random page order file sum, hot page cache\n";
+    print_file_methods(out, file_order::random);
+    print_grid(out, results);
+}
+void file_random_cold(std::ostream& out){
+    auto results = measure_file_access(smallest_file, largest_file, file_order::random, true);
+    out << "Random page order file sum, cold page cache\n";
+    print_file_methods(out, file_order::random);
+    print_grid(out, results);
+}
+
+template <typename T>
+using spsc_of = spsc_queue<T, queue_capacity>;
+template <typename T>
+using mpmc_of = mpmc_queue<T, queue_capacity>;
+template <typename T>
+using locked_of = locked_queue<T, queue_capacity>;
+
+void print_placements(std::ostream& out){
+    out << "Message bytes \\ Placement";
+    for (auto placement : thread_placements){
+        out << ",\t\t" << placement_name(placement);
+    }
+    out << '\n';
+}
+
+template <template <typename> class QueueOf>
+void print_queue_latencies(std::ostream& out){
+    for (auto placement : thread_placements){
+        auto results = measure_queue_latencies<QueueOf, 8, 64, 512>(placement);
+        out << placement_name(placement) << ": message bytes";
+        for (auto percentile : latency_percentiles){
+            out << ",\t\tp" << percentile;
+        }
+        out << '\n';
+        print_grid(out, results);
+    }
+}
+
+void queue_throughput_spsc(std::ostream& out){
+    auto results = measure_queue_placements<spsc_of, 8, 64, 512>();
+    out << "SPSC queue: messages/s\n";
+    print_placements(out);
+    print_grid(out, results);
+}
+void queue_throughput_mpmc(std::ostream& out){
+    auto results = measure_queue_placements<mpmc_of, 8, 64, 512>();
+    out << "MPMC queue: messages/s\n";
+    print_placements(out);
+    print_grid(out, results);
+}
+void queue_throughput_locked(std::ostream& out){
+    auto results = measure_queue_placements<locked_of, 8, 64, 512>();
+    out << "Mutex + condvar queue: messages/s\n";
+    print_placements(out);
+    print_grid(out, results);
+}
+void queue_latency_spsc(std::ostream& out){
+    out << "SPSC queue: round trip ns\n";
+    print_queue_latencies<spsc_of>(out);
+}
+void queue_latency_mpmc(std::ostream& out){
+    out << "MPMC queue: round trip ns\n";
+    print_queue_latencies<mpmc_of>(out);
+}
+void queue_latency_locked(std::ostream& out){
+    out << "Mutex + condvar queue: round trip ns\n";
+    print_queue_latencies<locked_of>(out);
+}
+void queue_contention_mpmc(std::ostream& out){
+    auto results = measure_queue_contention<mpmc_of, 8, 64, 512>();
+    out << "MPMC queue: messages/s\n";
+    out << "Producers = consumers \\ Message bytes,\t\t8,\t\t64,\t\t512\n";
+    print_grid(out, results);
+}
+void queue_contention_locked(std::ostream& out){
+    auto results = measure_queue_contention<locked_of, 8, 64, 512>();
+    out << "Mutex + condvar queue: messages/s\n";
+    out << "Producers = consumers \\ Message bytes,\t\t8,\t\t64,\t\t512\n";
+    print_grid(out, results);
+}
 
 using bencher = void (*)(std::ostream&);
 std::map<std::string, bencher> benches = {
@@ -134,10 +966,34 @@ std::map<std::string, bencher> benches = {
     {"reverse_sum_vector", reverse_sum_vector},
     {"smarter_matrix_multiply", smarter_matrix_multiply},
     {"naive_matrix_multiply", naive_matrix_multiply},
+    {"naive_matrix_multiply_padded", naive_matrix_multiply_padded},
+    {"smarter_matrix_multiply_padded", smarter_matrix_multiply_padded},
+    {"naive_matrix_transpose", naive_matrix_transpose},
+    {"naive_matrix_transpose_padded", naive_matrix_transpose_padded},
+    {"blocked_matrix_transpose", blocked_matrix_transpose},
+    {"blocked_matrix_transpose_padded", blocked_matrix_transpose_padded},
+    {"recursive_matrix_transpose", recursive_matrix_transpose},
+    {"recursive_matrix_transpose_padded", recursive_matrix_transpose_padded},
     {"sequential_sum_list", sequential_sum_list},
     {"sequential_sum_vector", sequential_sum_vector},
+    {"sequential_sum_deque", sequential_sum_deque},
+    {"sequential_sum_unrolled_list", sequential_sum_unrolled_list},
+    {"sequential_sum_unrolled_list_4lines", sequential_sum_unrolled_list_4lines},
+    {"reverse_sum_deque", reverse_sum_deque},
+    {"reverse_sum_unrolled_list", reverse_sum_unrolled_list},
+    {"reverse_sum_unrolled_list_4lines", reverse_sum_unrolled_list_4lines},
+    {"middle_insert_vector", middle_insert_vector},
+    {"middle_insert_list", middle_insert_list},
+    {"middle_insert_deque", middle_insert_deque},
+    {"middle_insert_unrolled_list", middle_insert_unrolled_list},
+    {"middle_insert_unrolled_list_4lines", middle_insert_unrolled_list_4lines},
     {"vector_element_skip", vector_element_skip},
     {"random_sum_vector", random_sum_vector},
+    {"sequential_access_modes", sequential_access_modes},
+    {"strided_access_modes", strided_access_modes},
+    {"random_access_modes", random_access_modes},
+    {"stride_capacity", stride_capacity},
+    {"store_load_aliasing", store_load_aliasing},
     {"read_map", read_map},
     {"read_write_map", read_write_map},
     {"read_heavy_map", read_heavy_map},
@@ -147,11 +1003,109 @@ std::map<std::string, bencher> benches = {
     {"polymorphic_vector", polymorphic_vector},
     {"polymorphic_sequence", polymorphic_sequence},
     {"write_map", write_map},
-    {"write_flatmap", write_flatmap}
+    {"sort_u32_random", sort_u32_random},
+    {"sort_u32_presorted", sort_u32_presorted},
+    {"sort_u32_reversed", sort_u32_reversed},
+    {"sort_u32_few_unique", sort_u32_few_unique},
+    {"sort_u64_random", sort_u64_random},
+    {"sort_u64_presorted", sort_u64_presorted},
+    {"sort_u64_reversed", sort_u64_reversed},
+    {"sort_u64_few_unique", sort_u64_few_unique},
+    {"hash_aggregation", hash_aggregation},
+    {"interleaved_lookup_sorted_array", interleaved_lookup_sorted_array},
+    {"interleaved_lookup_flatmap", interleaved_lookup_flatmap},
+    {"interleaved_lookup_hash_map", interleaved_lookup_hash_map},
+    {"compressed_lookup_flatmap", compressed_lookup_flatmap},
+    {"compressed_lookup_delta8", compressed_lookup_delta8},
+    {"compressed_lookup_delta16", compressed_lookup_delta16},
+    {"file_sequential_hot", file_sequential_hot},
+    {"file_sequential_cold", file_sequential_cold},
+    {"file_random_hot", file_random_hot},
+    {"file_random_cold", file_random_cold},
+    {"queue_throughput_spsc", queue_throughput_spsc},
+    {"queue_throughput_mpmc", queue_throughput_mpmc},
+    {"queue_throughput_locked", queue_throughput_locked},
+    {"queue_latency_spsc", queue_latency_spsc},
+    {"queue_latency_mpmc", queue_latency_mpmc},
+    {"queue_latency_locked", queue_latency_locked},
+    {"queue_contention_mpmc", queue_contention_mpmc},
+    {"queue_contention_locked", queue_contention_locked},
+    {"read_btree", read_btree},
+    {"read_write_btree", read_write_btree},
+    {"read_heavy_btree", read_heavy_btree},
+    {"read_btree_node_sizes", read_btree_node_sizes},
+    {"write_btree", write_btree},
+    {"range_scan_map", range_scan_map},
+    {"range_scan_flatmap", range_scan_flatmap},
+    {"range_scan_btree", range_scan_btree},
+    {"skewed_read_map", skewed_read_map},
+    {"skewed_read_flatmap", skewed_read_flatmap},
+    {"skewed_read_cached_map", skewed_read_cached_map},
+    {"skewed_read_cached_flatmap", skewed_read_cached_flatmap},
+    {"miss_read_map", miss_read_map},
+    {"miss_read_flatmap", miss_read_flatmap},
+    {"miss_read_bloom_map", miss_read_bloom_map},
+    {"miss_read_bloom_flatmap", miss_read_bloom_flatmap},
+    {"read_map_payloads", read_map_payloads},
+    {"read_flatmap_payloads", read_flatmap_payloads},
+    {"read_write_map_payloads", read_write_map_payloads},
+    {"read_write_flatmap_payloads", read_write_flatmap_payloads},
+    {"read_heavy_map_payloads", read_heavy_map_payloads},
+    {"read_heavy_flatmap_payloads", read_heavy_flatmap_payloads},
+    {"write_map_payloads", write_map_payloads},
+    {"write_flatmap_payloads", write_flatmap_payloads},
+    {"concurrent_read_map", concurrent_read_map},
+    {"concurrent_read_rcu_flatmap", concurrent_read_rcu_flatmap},
+    {"concurrent_read_seqlock_flatmap", concurrent_read_seqlock_flatmap},
+    {"write_flatmap", write_flatmap},
+    {"aos_update_1_fields", aos_update_1_fields},
+    {"aos_update_3_fields", aos_update_3_fields},
+    {"aos_update_8_fields", aos_update_8_fields},
+    {"soa_update_1_fields", soa_update_1_fields},
+    {"soa_update_3_fields", soa_update_3_fields},
+    {"soa_update_8_fields", soa_update_8_fields},
+    {"aosoa_update_1_fields", aosoa_update_1_fields},
+    {"aosoa_update_3_fields", aosoa_update_3_fields},
+    {"aosoa_update_8_fields", aosoa_update_8_fields}
 };
 
+template <typename T, char... Order>
+void register_ordered_multiply(std::map<std::string, bencher>& registry){
+    const char order[] = {Order..., '\0'};
+    registry[std::string("loop_order_multiply_") + order + "_" + element_name<T>::get()] = ordered_matrix_multiply<T, Order...>;
+}
+
+template <typename T>
+void register_loop_orders(std::map<std::string, bencher>& registry){
+    register_ordered_multiply<T, 'i', 'j', 'k'>(registry);
+    register_ordered_multiply<T, 'i', 'k', 'j'>(registry);
+    register_ordered_multiply<T, 'j', 'i', 'k'>(registry);
+    register_ordered_multiply<T, 'j', 'k', 'i'>(registry);
+    register_ordered_multiply<T, 'k', 'i', 'j'>(registry);
+    register_ordered_multiply<T, 'k', 'j', 'i'>(registry);
+}
+
+bool register_matrix_loop_orders(std::map<std::string, bencher>& registry){
+    register_loop_orders<float>(registry);
+    register_loop_orders<double>(registry);
+    register_loop_orders<std::int32_t>(registry);
+    return true;
+}
+
+const bool loop_orders_registered = register_matrix_loop_orders(benches);
+
+
+//If arg is name=value, stores the value and returns true.
+bool take_option(const std::string& arg, const std::string& name, std::string& value){
+    if (arg.compare(0, name.size(), name) != 0){
+        return false;
+    }
+    value = arg.substr(name.size());
+    return true;
+}
 
 void print_help() {
+    std::cerr << "Usage: [--trace=file.json] [--noise=llc|bandwidth[:threads[:bytes]]] benchmark..." << std::endl;
     std::cerr << "Specify a benchmark:" << std::endl;
     for (const auto& test : benches) {
         std::cerr << "    " << test.first << std::endl;
@@ -168,6 +1122,28 @@ int main(int argc, char** argv){
 //    call_first();
 
     std::vector<std::string> args(argv+1, argv+argc);
+    auto options_end = std::stable_partition(begin(args), end(args), [](const std::string& arg){
+        return arg.compare(0, 2, "--") == 0;
+    });
+    //If an option is given more than once, the last one wins.
+    std::string trace_path;
+    std::string noise_spec;
+    for (auto it = begin(args); it != options_end; ++it){
+        if (!take_option(*it, "--trace=", trace_path) && !take_option(*it, "--noise=", noise_spec)){
+            std::cerr << "I don't understand '" << *it << "'. " << std::endl;
+            print_help();
+            return 1;
+        }
+    }
+    args.erase(begin(args), options_end);
+
+    noise_config noise;
+    if (!noise_spec.empty() && !parse_noise(noise_spec, noise)){
+        std::cerr << "I don't understand noise '" << noise_spec << "'. " << std::endl;
+        print_help();
+        return 1;
+    }
+
     if (args.size() == 0) {
         print_help();
         return 1;
@@ -179,9 +1155,19 @@ int main(int argc, char** argv){
             return 1;
         }
     }
+    if (!trace_path.empty() && !start_tracing(trace_path)){
+        std::cerr << "Cannot trace into '" << trace_path << "'. " << std::endl;
+        return 1;
+    }
+    noisy_neighbors neighbors(noise);
+    if (noise.threads != 0){
+        std::cout << "Noise: " << describe_noise(noise) << '\n';
+    }
     for (const auto& arg : args){
+        trace_phase phase(arg.c_str());
         benches[arg](std::cout);
     }
+    stop_tracing();
 
     return 0;
 
@@ -1,10 +1,12 @@
+#include <algorithm>
+
 #include "matrix_multiplication.h"
 
 
 matrix multiply_naive(const matrix& lhs, const matrix& rhs){
     assert(lhs.columns() == rhs.rows() && "Dimension mismatch, cannot multiply matrices.\n");
 
-    matrix temp(lhs.rows(), rhs.columns());
+    matrix temp(lhs.rows(), rhs.columns(), lhs.padding());
     for (int i = 0, ei = lhs.rows(); i < ei; ++i){
         for (int j = 0, ej = rhs.columns(); j < ej; ++j){
             for (int k = 0, ek = lhs.columns(); k < ek; ++k){
@@ -18,7 +20,7 @@ matrix multiply_naive(const matrix& lhs, const matrix& rhs){
 matrix multiply_smarter(const matrix& lhs, const matrix& rhs){
     assert(lhs.columns() == rhs.rows() && "Dimension mismatch, cannot multiply matrices.\n");
 
-    matrix temp(lhs.rows(), rhs.columns());
+    matrix temp(lhs.rows(), rhs.columns(), lhs.padding());
     for (int i = 0, ei = lhs.rows(); i < ei; ++i){
         for (int j = 0, ej = rhs.columns(); j < ej; ++j){
             temp(i, j) = lhs(i, 0) * rhs(0, j);
@@ -33,3 +35,58 @@ matrix multiply_smarter(const matrix& lhs, const matrix& rhs){
 
     return temp;
 }
+
+
+matrix transpose_naive(const matrix& mat){
+    matrix temp(mat.columns(), mat.rows(), mat.padding());
+    for (int i = 0, ei = mat.rows(); i < ei; ++i){
+        for (int j = 0, ej = mat.columns(); j < ej; ++j){
+            temp(j, i) = mat(i, j);
+        }
+    }
+    return temp;
+}
+
+//8 doubles per cache line, so a block is 64 rows tall and 8 lines wide, 32 KiB of source and as much of destination.
+static const int transpose_block = 64;
+
+matrix transpose_blocked(const matrix& mat){
+    matrix temp(mat.columns(), mat.rows(), mat.padding());
+    for (int bi = 0, ei = mat.rows(); bi < ei; bi += transpose_block){
+        for (int bj = 0, ej = mat.columns(); bj < ej; bj += transpose_block){
+            for (int i = bi, ebi = std::min(bi + transpose_block, ei); i < ebi; ++i){
+                for (int j = bj, ebj = std::min(bj + transpose_block, ej); j < ebj; ++j){
+                    temp(j, i) = mat(i, j);
+                }
+            }
+        }
+    }
+    return temp;
+}
+
+//Below this many elements, the recursion stops and the block is transposed directly.
+static const int transpose_leaf = 16 * 16;
+
+static void transpose_recursive_impl(const matrix& mat, matrix& temp, int row, int rows, int column, int columns){
+    if (rows * columns <= transpose_leaf){
+        for (int i = row; i < row + rows; ++i){
+            for (int j = column; j < column + columns; ++j){
+                temp(j, i) = mat(i, j);
+            }
+        }
+    } else if (rows >= columns){
+        transpose_recursive_impl(mat, temp, row, rows / 2, column, columns);
+        transpose_recursive_impl(mat, temp, row + rows / 2, rows - rows / 2, column, columns);
+    } else {
+        transpose_recursive_impl(mat, temp, row, rows, column, columns / 2);
+        transpose_recursive_impl(mat, temp, row, rows, column + columns / 2, columns - columns / 2);
+    }
+}
+
+/* Cache oblivious transposition, splits the longer dimension in half until the block is small enough.
+ */
+matrix transpose_recursive(const matrix& mat){
+    matrix temp(mat.columns(), mat.rows(), mat.padding());
+    transpose_recursive_impl(mat, temp, 0, mat.rows(), 0, mat.columns());
+    return temp;
+}
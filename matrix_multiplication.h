@@ -7,25 +7,36 @@
 #include <cassert>
 #include <initializer_list>
 
-class matrix {
+#include "aligned_allocator.h"
+
+/* Dense, row-major matrix of T.
+ *
+ * Rows can be padded with extra elements, so that the stride between rows (leading dimension)
+ * is not a power of two and column walks do not keep hitting the same cache sets.
+ * Storage always starts at a cache line boundary.
+ */
+template <typename T>
+class basic_matrix {
 public:
-    matrix(){}
-    matrix(std::size_t rows, std::size_t columns)
-    :m{rows}, n{columns}, data(m*n){}
+    using value_type = T;
+
+    basic_matrix(){}
+    basic_matrix(std::size_t rows, std::size_t columns, std::size_t padding = 0)
+    :m{rows}, n{columns}, ld{columns + padding}, data(m*ld){}
 
-    matrix(std::initializer_list<std::initializer_list<double>> elems)
-    :m{elems.size()}, n{begin(elems)->size()} {
+    basic_matrix(std::initializer_list<std::initializer_list<T>> elems)
+    :m{elems.size()}, n{begin(elems)->size()}, ld{n} {
         for (auto& el : elems){
             data.insert(end(data), begin(el), end(el));
         }
     }
 
-    const double& operator()(int row, int column) const {
-        return data[row*n + column];
+    const T& operator()(int row, int column) const {
+        return data[row*ld + column];
     }
 
-    double& operator()(int row, int column){
-        return data[row*n + column];
+    T& operator()(int row, int column){
+        return data[row*ld + column];
     }
 
     std::size_t rows() const {
@@ -36,14 +47,83 @@ public:
         return n;
     }
 
+    std::size_t stride() const {
+        return ld;
+    }
+
+    std::size_t padding() const {
+        return ld - n;
+    }
+
 private:
-    std::size_t m = 0, n = 0;
-    std::vector<double> data;
+    std::size_t m = 0, n = 0, ld = 0;
+    std::vector<T, aligned_allocator<T>> data;
 
 };
 
+using matrix = basic_matrix<double>;
+
 matrix multiply_naive(const matrix& lhs, const matrix& rhs);
 matrix multiply_smarter(const matrix& lhs, const matrix& rhs);
 
+matrix transpose_naive(const matrix& mat);
+matrix transpose_blocked(const matrix& mat);
+matrix transpose_recursive(const matrix& mat);
+
+
+template <char... Order>
+struct loop_nest;
+
+template <>
+struct loop_nest<> {
+    template <typename Body>
+    static void run(const std::size_t (&)[3], Body& body, std::size_t i, std::size_t j, std::size_t k){
+        body(i, j, k);
+    }
+};
+
+/* Generates one loop of the nest per character of the pack, outermost first.
+ *
+ * Loop indices are passed down by value, so after inlining the nest is just plain nested loops.
+ */
+template <char Loop, char... Rest>
+struct loop_nest<Loop, Rest...> {
+    template <typename Body>
+    static void run(const std::size_t (&bounds)[3], Body& body, std::size_t i, std::size_t j, std::size_t k){
+        for (std::size_t x = 0, ex = bounds[Loop - 'i']; x < ex; ++x){
+            loop_nest<Rest...>::run(bounds, body, Loop == 'i' ? x : i, Loop == 'j' ? x : j, Loop == 'k' ? x : k);
+        }
+    }
+};
+
+template <char... Order>
+constexpr bool is_loop_order(){
+    const char order[] = {Order...};
+    bool seen[3] = {};
+    for (auto loop : order){
+        if (loop < 'i' || loop > 'k' || seen[loop - 'i']){
+            return false;
+        }
+        seen[loop - 'i'] = true;
+    }
+    return sizeof...(Order) == 3;
+}
+
+/* Multiplies matrices with the i, j, k loops nested in given Order (eg. 'i', 'k', 'j').
+ */
+template <typename T, char... Order>
+basic_matrix<T> multiply_ordered(const basic_matrix<T>& lhs, const basic_matrix<T>& rhs){
+    static_assert(is_loop_order<Order...>(), "Order must be a permutation of 'i', 'j', 'k'.");
+    assert(lhs.columns() == rhs.rows() && "Dimension mismatch, cannot multiply matrices.\n");
+
+    basic_matrix<T> temp(lhs.rows(), rhs.columns(), lhs.padding());
+    const std::size_t bounds[3] = {lhs.rows(), rhs.columns(), lhs.columns()};
+    auto body = [&](std::size_t i, std::size_t j, std::size_t k){
+        temp(i, j) += lhs(i, k) * rhs(k, j);
+    };
+    loop_nest<Order...>::run(bounds, body, 0, 0, 0);
+    return temp;
+}
+
 
 #endif
@@ -19,4 +19,24 @@ std::chrono::nanoseconds bench(Function func, int iterations){
     return t2-t1;
 }
 
+/* Same as bench, but calls setup before each iteration and only measures func.
+ *
+ * Useful when func destroys its input, like sorting does.
+ */
+template <typename Setup, typename Function>
+std::chrono::nanoseconds bench_with_setup(Setup setup, Function func, int iterations){
+    int temp = 0;
+    std::chrono::nanoseconds total(0);
+    for (int i = 0; i < iterations; ++i){
+        setup();
+        auto t1 = std::chrono::steady_clock::now();
+        temp += func();
+        auto t2 = std::chrono::steady_clock::now();
+        total += t2-t1;
+    }
+    static volatile int c = 0;
+    c = c + temp;
+    return total;
+}
+
 #endif
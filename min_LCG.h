@@ -6,6 +6,10 @@
 
 class LCG {
 public:
+    LCG() = default;
+    explicit LCG(uint32_t seed)
+    :state{seed}{}
+
     uint32_t get_next(){
         make_step();
         return state;
@@ -0,0 +1,183 @@
+#include <algorithm>
+#include <cstdint>
+#include <functional>
+#include <iostream>
+#include <limits>
+#include <sstream>
+
+#include "noisy_neighbor.h"
+#include "utilities.h"
+
+namespace {
+
+constexpr std::size_t hog_chunk_bytes = 1024 * 1024; //Stop flag is checked after every chunk.
+
+//Both signal ready after their first full pass over the buffer, so that the noise is at full strength from then on.
+void thrash_llc(std::uint64_t* data, std::size_t size, const std::atomic<bool>& stop, std::atomic<std::size_t>& ready){
+    const std::size_t step = cache_line_size / sizeof(std::uint64_t);
+    bool first_pass = true;
+    while (!stop.load(std::memory_order_relaxed)){
+        for (std::size_t i = 0; i < size; i += step){
+            ++data[i];
+        }
+        if (first_pass){
+            ready.fetch_add(1, std::memory_order_release);
+            first_pass = false;
+        }
+    }
+}
+
+void hog_bandwidth(std::uint64_t* data, std::size_t size, const std::atomic<bool>& stop, std::atomic<std::size_t>& ready){
+    const std::size_t half = size / 2;
+    const std::size_t chunk = hog_chunk_bytes / sizeof(std::uint64_t);
+    auto from = data;
+    auto to = data + half;
+    bool first_pass = true;
+    while (!stop.load(std::memory_order_relaxed)){
+        for (std::size_t i = 0; i < half && !stop.load(std::memory_order_relaxed); i += chunk){
+            auto length = std::min(chunk, half - i);
+            std::copy(from + i, from + i + length, to + i);
+        }
+        std::swap(from, to);
+        if (first_pass){
+            ready.fetch_add(1, std::memory_order_release);
+            first_pass = false;
+        }
+    }
+}
+
+//Digits, optionally followed by K, M or G.
+bool parse_count(const std::string& text, std::size_t& count){
+    auto digits_end = text.find_first_not_of("0123456789");
+    if (digits_end == 0 || text.size() - std::min(digits_end, text.size()) > 1){
+        return false;
+    }
+    constexpr std::size_t max_value = std::numeric_limits<std::size_t>::max();
+    std::size_t value = 0;
+    for (std::size_t i = 0; i < std::min(digits_end, text.size()); ++i){
+        const std::size_t digit = text[i] - '0';
+        if (value > (max_value - digit) / 10){
+            return false;
+        }
+        value = value * 10 + digit;
+    }
+    if (digits_end != std::string::npos){
+        unsigned shift = 0;
+        switch (text[digits_end]){
+        case 'K': shift = 10; break;
+        case 'M': shift = 20; break;
+        case 'G': shift = 30; break;
+        default: return false;
+        }
+        if (value > (max_value >> shift)){
+            return false;
+        }
+        value <<= shift;
+    }
+    count = value;
+    return true;
+}
+
+}
+
+bool parse_noise(const std::string& spec, noise_config& config){
+    std::istringstream in(spec);
+    std::string kind, threads, bytes;
+    std::getline(in, kind, ':');
+    std::getline(in, threads, ':');
+    std::getline(in, bytes, ':');
+    if (!in.eof() && in.peek() != std::char_traits<char>::eof()){
+        return false;
+    }
+
+    noise_config result;
+    result.threads = 1;
+    if (kind == "llc"){
+        result.kind = noise_kind::llc_thrash;
+        result.bytes = default_llc_thrash_bytes;
+    } else if (kind == "bandwidth"){
+        result.kind = noise_kind::bandwidth_hog;
+        result.bytes = default_bandwidth_hog_bytes;
+    } else {
+        return false;
+    }
+
+    if (!threads.empty() && !parse_count(threads, result.threads)){
+        return false;
+    }
+    if (!bytes.empty() && !parse_count(bytes, result.bytes)){
+        return false;
+    }
+
+    if (result.threads == 0 || result.bytes == 0){
+        return false;
+    }
+    config = result;
+    return true;
+}
+
+std::string describe_noise(const noise_config& config){
+    if (config.threads == 0){
+        return "none";
+    }
+    std::ostringstream out;
+    out << config.threads << (config.kind == noise_kind::llc_thrash ? " LLC thrasher(s)" : " bandwidth hog(s)")
+        << " over " << config.bytes << " bytes each";
+    return out.str();
+}
+
+noisy_neighbors::noisy_neighbors(const noise_config& config){
+    if (config.threads == 0){
+        return;
+    }
+
+    const auto cpus = allowed_cpus();
+    if (cpus.size() <= config.threads){
+        std::cerr << "Only " << cpus.size() << " CPU(s), noise threads will share a core with the benchmark." << std::endl;
+    }
+    const unsigned home = current_cpu();
+    if (!pin_current_thread(home)){
+        std::cerr << "Cannot pin the benchmark thread to CPU " << home << '.' << std::endl;
+    }
+    const std::size_t home_index = std::find(begin(cpus), end(cpus), home) - begin(cpus);
+
+    //Allocated here rather than by the threads, so that it happens before any benchmark and its allocation_scope starts.
+    const std::size_t words = config.kind == noise_kind::llc_thrash
+        ? std::max<std::size_t>(config.bytes / sizeof(std::uint64_t), 1)
+        : 2 * std::max<std::size_t>(config.bytes / sizeof(std::uint64_t) / 2, 1);
+    buffers.reserve(config.threads);
+    for (std::size_t i = 0; i < config.threads; ++i){
+        buffers.emplace_back(words, 1);
+    }
+
+    for (std::size_t i = 0; i < config.threads; ++i){
+        auto& buffer = buffers[i];
+        if (config.kind == noise_kind::llc_thrash){
+            threads.emplace_back(thrash_llc, buffer.data(), buffer.size(), std::cref(stop), std::ref(ready));
+        } else {
+            threads.emplace_back(hog_bandwidth, buffer.data(), buffer.size(), std::cref(stop), std::ref(ready));
+        }
+        auto cpu = cpus[(home_index + 1 + i) % cpus.size()];
+        if (!pin_thread(threads.back(), cpu)){
+            std::cerr << "Cannot pin noise thread to CPU " << cpu << '.' << std::endl;
+        } else if (cpu != home){
+            reserve_cpu(cpu);
+            reserved.push_back(cpu);
+        }
+    }
+
+    //The first benchmark must not start before every thread is generating noise.
+    while (ready.load(std::memory_order_acquire) < threads.size()){
+        std::this_thread::yield();
+    }
+}
+
+noisy_neighbors::~noisy_neighbors(){
+    stop = true;
+    for (auto& thread : threads){
+        thread.join();
+    }
+    for (auto cpu : reserved){
+        release_cpu(cpu);
+    }
+}
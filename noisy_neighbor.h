@@ -0,0 +1,61 @@
+#pragma once
+#ifndef WTF_NOISY_NEIGHBOR
+#define WTF_NOISY_NEIGHBOR
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "aligned_allocator.h"
+
+enum class noise_kind {
+    llc_thrash,     //Dirties every cache line of a buffer around the size of the LLC, over and over.
+    bandwidth_hog   //Copies between two halves of a buffer far larger than the LLC.
+};
+
+constexpr std::size_t default_llc_thrash_bytes = 16 * 1024 * 1024;
+constexpr std::size_t default_bandwidth_hog_bytes = 256 * 1024 * 1024;
+
+struct noise_config {
+    noise_kind kind = noise_kind::llc_thrash;
+    std::size_t threads = 0;
+    std::size_t bytes = 0; //Per thread.
+};
+
+/* Parses "kind[:threads[:bytes]]", where kind is llc or bandwidth and bytes can end with K, M or G.
+ *
+ * Threads default to 1 and bytes to the default for given kind. Returns false on malformed spec.
+ */
+bool parse_noise(const std::string& spec, noise_config& config);
+
+std::string describe_noise(const noise_config& config);
+
+/* Runs background threads generating cache and memory bandwidth contention, for as long as it lives.
+ *
+ * The calling thread is pinned to the CPU it currently runs on and the noise threads to the following CPUs,
+ * so that the noise competes for the shared LLC and memory controller, not for the benchmark's core.
+ * Threads started by the benchmarks inherit the calling thread's pinning, so they have to call unpin_current_thread.
+ * CPUs taken by the noise are marked with reserve_cpu, so that benchmarks placing their own threads avoid them.
+ * Pinning is only done on Linux, elsewhere the scheduler decides and a warning is printed.
+ * Buffers are allocated by the constructor, which returns only after every thread finished its first pass over its buffer.
+ */
+class noisy_neighbors {
+public:
+    explicit noisy_neighbors(const noise_config& config);
+    ~noisy_neighbors();
+
+    noisy_neighbors(const noisy_neighbors&) = delete;
+    noisy_neighbors& operator=(const noisy_neighbors&) = delete;
+
+private:
+    std::atomic<bool> stop{false};
+    std::atomic<std::size_t> ready{0}; //Threads that finished their first pass.
+    std::vector<std::vector<std::uint64_t, aligned_allocator<std::uint64_t>>> buffers;
+    std::vector<std::thread> threads;
+    std::vector<unsigned> reserved;
+};
+
+#endif
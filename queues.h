@@ -0,0 +1,242 @@
+#pragma once
+#ifndef WTF_QUEUES
+#define WTF_QUEUES
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "aligned_allocator.h"
+#include "utilities.h"
+
+/* Bounded queues for handing values between threads, all with the same interface.
+ *
+ * try_push and try_pop never block. push and pop wait until they succeed, lock-free queues spin
+ * for a while and then start yielding, so that they still make progress when threads share a CPU.
+ */
+
+constexpr unsigned queue_spins_before_yield = 64;
+
+inline void queue_backoff(unsigned& spins){
+    if (++spins > queue_spins_before_yield){
+        std::this_thread::yield();
+    }
+}
+
+/* Single producer, single consumer ring buffer.
+ *
+ * Head and tail live on separate cache lines, each next to the other side's index as last seen,
+ * so that the producer and the consumer only touch each other's line when the cached index runs out.
+ */
+template <typename T, std::size_t Capacity>
+class spsc_queue {
+    static_assert(is_power_of_2(Capacity), "Capacity must be a power of two.");
+
+public:
+    using value_type = T;
+
+    spsc_queue()
+    :slots(Capacity){}
+
+    bool try_push(const T& value){
+        auto current = tail.load(std::memory_order_relaxed);
+        if (current - cached_head == Capacity){
+            cached_head = head.load(std::memory_order_acquire);
+            if (current - cached_head == Capacity){
+                return false;
+            }
+        }
+        slots[current & (Capacity - 1)] = value;
+        tail.store(current + 1, std::memory_order_release);
+        return true;
+    }
+
+    bool try_pop(T& value){
+        auto current = head.load(std::memory_order_relaxed);
+        if (current == cached_tail){
+            cached_tail = tail.load(std::memory_order_acquire);
+            if (current == cached_tail){
+                return false;
+            }
+        }
+        value = slots[current & (Capacity - 1)];
+        head.store(current + 1, std::memory_order_release);
+        return true;
+    }
+
+    void push(const T& value){
+        for (unsigned spins = 0; !try_push(value); queue_backoff(spins)){}
+    }
+
+    void pop(T& value){
+        for (unsigned spins = 0; !try_pop(value); queue_backoff(spins)){}
+    }
+
+private:
+    //Written by the consumer.
+    alignas(cache_line_size) std::atomic<std::size_t> head{0};
+    std::size_t cached_tail = 0;
+    //Written by the producer.
+    alignas(cache_line_size) std::atomic<std::size_t> tail{0};
+    std::size_t cached_head = 0;
+    alignas(cache_line_size) std::vector<T> slots;
+};
+
+/* Multi producer, multi consumer ring buffer, after Dmitry Vyukov's bounded MPMC queue.
+ *
+ * Every cell carries a sequence number, that tells producers and consumers whose turn it is,
+ * so claiming a cell is a single CAS on the shared position.
+ */
+template <typename T, std::size_t Capacity>
+class mpmc_queue {
+    static_assert(is_power_of_2(Capacity), "Capacity must be a power of two.");
+
+    struct cell {
+        std::atomic<std::size_t> sequence;
+        T data;
+    };
+
+public:
+    using value_type = T;
+
+    mpmc_queue()
+    :cells(Capacity){
+        for (std::size_t i = 0; i < Capacity; ++i){
+            cells[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    bool try_push(const T& value){
+        auto pos = enqueue_pos.load(std::memory_order_relaxed);
+        cell* target;
+        for (;;){
+            target = &cells[pos & (Capacity - 1)];
+            auto sequence = target->sequence.load(std::memory_order_acquire);
+            auto diff = static_cast<std::intptr_t>(sequence) - static_cast<std::intptr_t>(pos);
+            if (diff == 0){
+                if (enqueue_pos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)){
+                    break;
+                }
+            } else if (diff < 0){
+                return false;
+            } else {
+                pos = enqueue_pos.load(std::memory_order_relaxed);
+            }
+        }
+        target->data = value;
+        target->sequence.store(pos + 1, std::memory_order_release);
+        return true;
+    }
+
+    bool try_pop(T& value){
+        auto pos = dequeue_pos.load(std::memory_order_relaxed);
+        cell* target;
+        for (;;){
+            target = &cells[pos & (Capacity - 1)];
+            auto sequence = target->sequence.load(std::memory_order_acquire);
+            auto diff = static_cast<std::intptr_t>(sequence) - static_cast<std::intptr_t>(pos + 1);
+            if (diff == 0){
+                if (dequeue_pos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)){
+                    break;
+                }
+            } else if (diff < 0){
+                return false;
+            } else {
+                pos = dequeue_pos.load(std::memory_order_relaxed);
+            }
+        }
+        value = target->data;
+        target->sequence.store(pos + Capacity, std::memory_order_release);
+        return true;
+    }
+
+    void push(const T& value){
+        for (unsigned spins = 0; !try_push(value); queue_backoff(spins)){}
+    }
+
+    void pop(T& value){
+        for (unsigned spins = 0; !try_pop(value); queue_backoff(spins)){}
+    }
+
+private:
+    alignas(cache_line_size) std::atomic<std::size_t> enqueue_pos{0};
+    alignas(cache_line_size) std::atomic<std::size_t> dequeue_pos{0};
+    alignas(cache_line_size) std::vector<cell> cells;
+};
+
+/* Ring buffer behind a mutex, waiting threads sleep on condition variables. The baseline.
+ */
+template <typename T, std::size_t Capacity>
+class locked_queue {
+public:
+    using value_type = T;
+
+    locked_queue()
+    :slots(Capacity){}
+
+    bool try_push(const T& value){
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (count == Capacity){
+                return false;
+            }
+            push_locked(value);
+        }
+        not_empty.notify_one();
+        return true;
+    }
+
+    bool try_pop(T& value){
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (count == 0){
+                return false;
+            }
+            pop_locked(value);
+        }
+        not_full.notify_one();
+        return true;
+    }
+
+    void push(const T& value){
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            not_full.wait(lock, [&](){ return count < Capacity; });
+            push_locked(value);
+        }
+        not_empty.notify_one();
+    }
+
+    void pop(T& value){
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            not_empty.wait(lock, [&](){ return count > 0; });
+            pop_locked(value);
+        }
+        not_full.notify_one();
+    }
+
+private:
+    void push_locked(const T& value){
+        slots[(head + count) % Capacity] = value;
+        ++count;
+    }
+
+    void pop_locked(T& value){
+        value = slots[head];
+        head = (head + 1) % Capacity;
+        --count;
+    }
+
+    std::mutex mutex;
+    std::condition_variable not_empty;
+    std::condition_variable not_full;
+    std::vector<T> slots;
+    std::size_t head = 0;
+    std::size_t count = 0;
+};
+
+#endif
@@ -0,0 +1,117 @@
+#pragma once
+#ifndef WTF_RECORD_LAYOUTS
+#define WTF_RECORD_LAYOUTS
+
+#include <array>
+#include <vector>
+#include <cstddef>
+
+#include "data_generation.h"
+
+constexpr std::size_t record_fields = 8;
+constexpr std::size_t aosoa_lanes = 8; //8 floats fill one AVX register.
+
+/* Updates single field in the same way for every layout, so that only the memory layout differs.
+ */
+inline void update_field(float& field){
+    field = field * 0.5f + 1.0f;
+}
+
+/* Array of structs, all fields of one record are next to each other.
+ */
+class aos_records {
+public:
+    explicit aos_records(std::size_t size)
+    :storage(size){
+        auto values = generate_random_sequence(size * record_fields);
+        for (std::size_t i = 0; i < size; ++i){
+            for (std::size_t f = 0; f < record_fields; ++f){
+                storage[i].fields[f] = values[i * record_fields + f];
+            }
+        }
+    }
+
+    template <std::size_t Fields>
+    float update(){
+        for (auto& rec : storage){
+            for (std::size_t f = 0; f < Fields; ++f){
+                update_field(rec.fields[f]);
+            }
+        }
+        return storage[0].fields[0];
+    }
+
+private:
+    struct record {
+        float fields[record_fields];
+    };
+    std::vector<record> storage;
+};
+
+/* Struct of arrays, every field lives in its own array.
+ */
+class soa_records {
+public:
+    explicit soa_records(std::size_t size){
+        auto values = generate_random_sequence(size * record_fields);
+        for (std::size_t f = 0; f < record_fields; ++f){
+            columns[f].resize(size);
+            for (std::size_t i = 0; i < size; ++i){
+                columns[f][i] = values[i * record_fields + f];
+            }
+        }
+    }
+
+    template <std::size_t Fields>
+    float update(){
+        for (std::size_t f = 0; f < Fields; ++f){
+            for (auto& field : columns[f]){
+                update_field(field);
+            }
+        }
+        return columns[0][0];
+    }
+
+private:
+    std::array<std::vector<float>, record_fields> columns;
+};
+
+/* Array of structs of arrays, records are grouped into blocks of aosoa_lanes
+ * and inside a block, each field is stored as a short array.
+ *
+ * Size is rounded up to whole blocks.
+ */
+class aosoa_records {
+public:
+    explicit aosoa_records(std::size_t size)
+    :storage((size + aosoa_lanes - 1) / aosoa_lanes){
+        auto values = generate_random_sequence(storage.size() * aosoa_lanes * record_fields);
+        for (std::size_t b = 0; b < storage.size(); ++b){
+            for (std::size_t l = 0; l < aosoa_lanes; ++l){
+                for (std::size_t f = 0; f < record_fields; ++f){
+                    storage[b].fields[f][l] = values[(b * aosoa_lanes + l) * record_fields + f];
+                }
+            }
+        }
+    }
+
+    template <std::size_t Fields>
+    float update(){
+        for (auto& blk : storage){
+            for (std::size_t f = 0; f < Fields; ++f){
+                for (std::size_t l = 0; l < aosoa_lanes; ++l){
+                    update_field(blk.fields[f][l]);
+                }
+            }
+        }
+        return storage[0].fields[0][0];
+    }
+
+private:
+    struct block {
+        float fields[record_fields][aosoa_lanes];
+    };
+    std::vector<block> storage;
+};
+
+#endif
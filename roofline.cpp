@@ -0,0 +1,233 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <fstream>
+#include <iostream>
+#include <numeric>
+#include <vector>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+#include "roofline.h"
+#include "aligned_allocator.h"
+
+namespace {
+
+constexpr std::size_t bandwidth_pass_bytes = std::size_t(1) << 27; //Every level is summed over this many bytes per pass.
+constexpr double main_memory_buffer = double(1 << 27); //128 MiB, unless the LLC is so big that this needs to be more.
+constexpr std::size_t compute_iterations = 1 << 22;
+constexpr std::size_t compute_chains = 8; //Enough independent chains to cover the latency of a multiply-add.
+constexpr int peak_passes = 3;
+
+template <typename Function>
+double best_seconds(Function func){
+    double best = 1e300;
+    for (int pass = 0; pass < peak_passes; ++pass){
+        auto t1 = std::chrono::steady_clock::now();
+        func();
+        auto t2 = std::chrono::steady_clock::now();
+        best = std::min(best, std::chrono::duration<double>(t2 - t1).count());
+    }
+    return best;
+}
+
+struct cache_level {
+    int level;
+    double capacity;
+};
+
+//Data and unified caches of CPU 0, sorted by level. Falls back to typical sizes where sysfs is not available.
+std::vector<cache_level> cache_levels(){
+    std::vector<cache_level> levels;
+    for (int index = 0; ; ++index){
+        const std::string dir = "/sys/devices/system/cpu/cpu0/cache/index" + std::to_string(index) + "/";
+        std::ifstream level_file(dir + "level"), type_file(dir + "type"), size_file(dir + "size");
+        int level = 0;
+        std::string type;
+        double size = 0;
+        char unit = 0;
+        if (!(level_file >> level) || !(type_file >> type) || !(size_file >> size)){
+            break;
+        }
+        if (size_file >> unit){
+            size *= unit == 'K' ? 1024.0 : unit == 'M' ? 1024.0 * 1024 : unit == 'G' ? 1024.0 * 1024 * 1024 : 1;
+        }
+        if (type != "Instruction"){
+            levels.push_back({level, size});
+        }
+    }
+    if (levels.empty()){
+        std::cerr << "Cannot read cache sizes, assuming 32 KiB L1, 1 MiB L2 and 8 MiB L3." << std::endl;
+        levels = {{1, 32.0 * 1024}, {2, 1024.0 * 1024}, {3, 8.0 * 1024 * 1024}};
+    }
+    std::sort(begin(levels), end(levels), [](const cache_level& lhs, const cache_level& rhs){ return lhs.level < rhs.level; });
+    return levels;
+}
+
+//Four independent accumulators, so that the sum is limited by loads and not by the latency of the adds.
+std::uint64_t sum_buffer(const std::uint64_t* data, std::size_t n){
+#if defined(__SSE2__)
+    __m128i acc[4] = {_mm_setzero_si128(), _mm_setzero_si128(), _mm_setzero_si128(), _mm_setzero_si128()};
+    for (std::size_t i = 0; i + 8 <= n; i += 8){
+        for (int k = 0; k < 4; ++k){
+            acc[k] = _mm_add_epi64(acc[k], _mm_load_si128(reinterpret_cast<const __m128i*>(data + i + 2 * k)));
+        }
+    }
+    alignas(16) std::uint64_t lanes[2];
+    _mm_store_si128(reinterpret_cast<__m128i*>(lanes), _mm_add_epi64(_mm_add_epi64(acc[0], acc[1]), _mm_add_epi64(acc[2], acc[3])));
+    return lanes[0] + lanes[1];
+#else
+    std::uint64_t acc[4] = {};
+    for (std::size_t i = 0; i + 4 <= n; i += 4){
+        for (int k = 0; k < 4; ++k){
+            acc[k] += data[i + k];
+        }
+    }
+    return acc[0] + acc[1] + acc[2] + acc[3];
+#endif
+}
+
+double measure_bandwidth(double buffer_bytes){
+    const auto elements = std::max<std::size_t>(static_cast<std::size_t>(buffer_bytes) / sizeof(std::uint64_t) / 8 * 8, 8);
+    const auto repeats = std::max<std::size_t>(bandwidth_pass_bytes / (elements * sizeof(std::uint64_t)), 1);
+    std::vector<std::uint64_t, aligned_allocator<std::uint64_t>> data(elements, 1);
+    static volatile std::uint64_t c = 0;
+    sum_buffer(data.data(), elements); //Warms up the cache level.
+    auto seconds = best_seconds([&](){
+        std::uint64_t temp = 0;
+        for (std::size_t r = 0; r < repeats; ++r){
+            temp += sum_buffer(data.data(), elements);
+        }
+        c = c + temp;
+    });
+    return repeats * elements * sizeof(std::uint64_t) / seconds;
+}
+
+std::vector<memory_roof> measure_memory(){
+    std::vector<memory_roof> roofs;
+    double largest = 0;
+    for (const auto& level : cache_levels()){
+        roofs.push_back({"L" + std::to_string(level.level), level.capacity, measure_bandwidth(level.capacity / 2)});
+        largest = std::max(largest, level.capacity);
+    }
+    roofs.push_back({"DRAM", 1e300, measure_bandwidth(std::max(main_memory_buffer, 8 * largest))});
+    return roofs;
+}
+
+//Multiplier and addend keep floating point chains bounded, unsigned integers just wrap around.
+template <typename T>
+struct chain_constants {
+    static T multiplier(){ return T(0.999999); }
+    static T addend(){ return T(0.5); }
+};
+
+template <>
+struct chain_constants<std::uint32_t> {
+    static std::uint32_t multiplier(){ return 2654435761u; }
+    static std::uint32_t addend(){ return 1; }
+};
+
+template <>
+struct chain_constants<std::uint64_t> {
+    static std::uint64_t multiplier(){ return 6364136223846793005ull; }
+    static std::uint64_t addend(){ return 1442695040888963407ull; }
+};
+
+//Lane is the element type, Chain either the same type or a 16 byte vector of it.
+template <typename Lane, typename Chain>
+double measure_compute(){
+    constexpr std::size_t lanes = sizeof(Chain) / sizeof(Lane);
+    static volatile Lane seed = 1;
+    const Chain multiplier = Chain{} + chain_constants<Lane>::multiplier();
+    const Chain addend = Chain{} + chain_constants<Lane>::addend();
+    auto seconds = best_seconds([&](){
+        Chain acc[compute_chains];
+        for (std::size_t i = 0; i < compute_chains; ++i){
+            acc[i] = Chain{} + static_cast<Lane>(seed + i);
+        }
+        for (std::size_t it = 0; it < compute_iterations; ++it){
+            for (auto& a : acc){
+                a = a * multiplier + addend;
+            }
+        }
+        Chain total = Chain{};
+        for (const auto& a : acc){
+            total = total + a;
+        }
+        Lane lane_total = 0;
+        for (std::size_t i = 0; i < lanes; ++i){
+            lane_total += reinterpret_cast<const Lane*>(&total)[i];
+        }
+        seed = seed + lane_total;
+    });
+    return 2.0 * compute_iterations * compute_chains * lanes / seconds;
+}
+
+template <typename Lane>
+double measure_vector_compute(){
+#if defined(__GNUC__)
+    typedef Lane vector_type __attribute__((vector_size(16)));
+    return measure_compute<Lane, vector_type>();
+#else
+    return 0;
+#endif
+}
+
+const char* op_type_name(op_type type){
+    switch (type){
+    case op_type::f32: return "f32";
+    case op_type::i32: return "i32";
+    case op_type::i64: return "i64";
+    default: return "f64";
+    }
+}
+
+}
+
+const machine_peaks& host_peaks(){
+    static const machine_peaks peaks = [](){
+        machine_peaks measured;
+        measured.memory = measure_memory();
+        measured.scalar_ops_per_second[static_cast<int>(op_type::f64)] = measure_compute<double, double>();
+        measured.scalar_ops_per_second[static_cast<int>(op_type::f32)] = measure_compute<float, float>();
+        measured.scalar_ops_per_second[static_cast<int>(op_type::i32)] = measure_compute<std::uint32_t, std::uint32_t>();
+        measured.scalar_ops_per_second[static_cast<int>(op_type::i64)] = measure_compute<std::uint64_t, std::uint64_t>();
+        measured.vector_ops_per_second[static_cast<int>(op_type::f64)] = measure_vector_compute<double>();
+        measured.vector_ops_per_second[static_cast<int>(op_type::f32)] = measure_vector_compute<float>();
+        measured.vector_ops_per_second[static_cast<int>(op_type::i32)] = measure_vector_compute<std::uint32_t>();
+        measured.vector_ops_per_second[static_cast<int>(op_type::i64)] = measure_vector_compute<std::uint64_t>();
+
+        std::cerr << "Host peaks:";
+        for (const auto& roof : measured.memory){
+            std::cerr << ' ' << roof.name << ' ' << roof.bytes_per_second / 1e9 << " GB/s,";
+        }
+        for (std::size_t type = 0; type < op_type_count; ++type){
+            std::cerr << ' ' << op_type_name(static_cast<op_type>(type)) << ' ' << measured.scalar_ops_per_second[type] / 1e9
+                      << " (vector " << measured.vector_ops_per_second[type] / 1e9 << ") Gops/s" << (type + 1 < op_type_count ? "," : "");
+        }
+        std::cerr << std::endl;
+        return measured;
+    }();
+    return peaks;
+}
+
+const memory_roof& memory_roof_for(const run_work& work){
+    const auto& memory = host_peaks().memory;
+    const auto working_set = work.working_set > 0 ? work.working_set : work.bytes;
+    for (const auto& roof : memory){
+        if (working_set <= roof.capacity){
+            return roof;
+        }
+    }
+    return memory.back();
+}
+
+double roofline_fraction(const run_work& work, double seconds){
+    const auto& peaks = host_peaks();
+    const auto type = static_cast<int>(work.type);
+    const auto ops_per_second = std::max(peaks.scalar_ops_per_second[type], peaks.vector_ops_per_second[type]);
+    auto roof = std::max(work.bytes / memory_roof_for(work).bytes_per_second, work.ops / ops_per_second);
+    return seconds > 0 ? roof / seconds : 0;
+}
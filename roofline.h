@@ -0,0 +1,76 @@
+#pragma once
+#ifndef WTF_ROOFLINE
+#define WTF_ROOFLINE
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+//Element type the arithmetic of a run is done on, every one of them has its own compute roof.
+enum class op_type {
+    f64,
+    f32,
+    i32,
+    i64
+};
+
+constexpr std::size_t op_type_count = 4;
+
+template <typename T>
+constexpr op_type op_type_of(){
+    return std::is_floating_point<T>::value ? (sizeof(T) == sizeof(float) ? op_type::f32 : op_type::f64)
+                                            : (sizeof(T) <= sizeof(std::int32_t) ? op_type::i32 : op_type::i64);
+}
+
+/* Work done by a single run of a benchmark, at one size.
+ *
+ * Bytes are the bytes of data the algorithm has to read or write, not the traffic caused by the container's
+ * own overhead, so that containers holding the same data are compared against the same roof.
+ * Working set is the data the run keeps coming back to, it picks the memory level the bytes are served from.
+ * Zero means that it is the same as bytes.
+ * Ops are arithmetic operations on the elements, a fused multiply-add counts as two.
+ */
+struct run_work {
+    double elements;
+    double bytes;
+    double ops;
+    double working_set = 0;
+    op_type type = op_type::f64;
+};
+
+//Bandwidth of one level of the memory hierarchy, reachable by data that fits into capacity.
+struct memory_roof {
+    std::string name;
+    double capacity;
+    double bytes_per_second;
+};
+
+/* Peak single threaded bandwidth of every cache level and main memory, and arithmetic throughput of the host.
+ *
+ * Cache sizes come from /sys/devices/system/cpu/cpu0/cache, bandwidth of each level is measured by summing
+ * a buffer half its size with SSE2 loads, main memory with a buffer far larger than the LLC.
+ * Compute is measured by independent multiply-add chains for every op_type, both with scalars and with
+ * 16 byte vectors, and the faster of the two is the roof. Everything is taken as the best of several passes.
+ */
+struct machine_peaks {
+    std::vector<memory_roof> memory; //From the fastest, the last one is main memory with unlimited capacity.
+    double scalar_ops_per_second[op_type_count];
+    double vector_ops_per_second[op_type_count];
+};
+
+//Measured on first use, which takes a second or two.
+const machine_peaks& host_peaks();
+
+//Memory level the work's working set fits into.
+const memory_roof& memory_roof_for(const run_work& work);
+
+/* Fraction of the roofline reached by a run that did given work in given time.
+ *
+ * The roof is the slower of moving work.bytes at the bandwidth of memory_roof_for the work,
+ * and doing work.ops at the peak compute for work.type.
+ */
+double roofline_fraction(const run_work& work, double seconds);
+
+#endif
@@ -0,0 +1,119 @@
+#pragma once
+#ifndef WTF_SORTING
+#define WTF_SORTING
+
+#include <algorithm>
+#include <iterator>
+#include <vector>
+#include <cstdint>
+#include <type_traits>
+
+constexpr std::size_t radix_bits = 8;
+constexpr std::size_t merge_block_bytes = 256 * 1024; //Roughly a typical L2.
+
+/* LSD radix sort of unsigned integer keys, one byte per pass.
+ *
+ * Passes where all keys share the same digit are skipped, which helps with few unique keys.
+ */
+template <typename RandomIt>
+void radix_sort_lsd(RandomIt first, RandomIt last){
+    using key_type = typename std::iterator_traits<RandomIt>::value_type;
+    static_assert(std::is_unsigned<key_type>::value, "Radix sort only handles unsigned keys.");
+    constexpr std::size_t buckets = 1 << radix_bits;
+
+    const std::size_t n = last - first;
+    if (n < 2){
+        return;
+    }
+    std::vector<key_type> buffer(n);
+    auto from = &*first;
+    auto to = buffer.data();
+
+    for (std::size_t shift = 0; shift < sizeof(key_type) * 8; shift += radix_bits){
+        std::size_t counts[buckets] = {};
+        for (std::size_t i = 0; i < n; ++i){
+            ++counts[(from[i] >> shift) & (buckets - 1)];
+        }
+        if (std::find(counts, counts + buckets, n) != counts + buckets){
+            continue;
+        }
+
+        std::size_t offset = 0;
+        for (auto& count : counts){
+            auto temp = count;
+            count = offset;
+            offset += temp;
+        }
+        for (std::size_t i = 0; i < n; ++i){
+            to[counts[(from[i] >> shift) & (buckets - 1)]++] = from[i];
+        }
+        std::swap(from, to);
+    }
+
+    if (from != &*first){
+        std::copy(from, from + n, first);
+    }
+}
+
+/* Merge sort that first sorts blocks fitting into merge_block_bytes with std::sort
+ * and then merges them pairwise, bouncing between the input and a buffer.
+ */
+template <typename RandomIt>
+void blocked_merge_sort(RandomIt first, RandomIt last){
+    using key_type = typename std::iterator_traits<RandomIt>::value_type;
+    const std::size_t block = std::max<std::size_t>(1, merge_block_bytes / sizeof(key_type));
+
+    const std::size_t n = last - first;
+    if (n < 2){
+        return;
+    }
+    for (std::size_t i = 0; i < n; i += block){
+        std::sort(first + i, first + std::min(i + block, n));
+    }
+
+    std::vector<key_type> buffer(n);
+    auto from = &*first;
+    auto to = buffer.data();
+    for (std::size_t width = block; width < n; width *= 2){
+        for (std::size_t i = 0; i < n; i += 2 * width){
+            auto mid = std::min(i + width, n);
+            auto end = std::min(i + 2 * width, n);
+            std::merge(from + i, from + mid, from + mid, from + end, to + i);
+        }
+        std::swap(from, to);
+    }
+
+    if (from != &*first){
+        std::copy(from, from + n, first);
+    }
+}
+
+struct std_sorter {
+    template <typename RandomIt>
+    void operator()(RandomIt first, RandomIt last) const {
+        std::sort(first, last);
+    }
+};
+
+struct stable_sorter {
+    template <typename RandomIt>
+    void operator()(RandomIt first, RandomIt last) const {
+        std::stable_sort(first, last);
+    }
+};
+
+struct radix_sorter {
+    template <typename RandomIt>
+    void operator()(RandomIt first, RandomIt last) const {
+        radix_sort_lsd(first, last);
+    }
+};
+
+struct blocked_merge_sorter {
+    template <typename RandomIt>
+    void operator()(RandomIt first, RandomIt last) const {
+        blocked_merge_sort(first, last);
+    }
+};
+
+#endif
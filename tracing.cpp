@@ -0,0 +1,129 @@
+#include "tracing.h"
+
+#ifndef WTF_DISABLE_TRACING
+
+#include <atomic>
+#include <chrono>
+#include <fstream>
+#include <iomanip>
+#include <mutex>
+#include <vector>
+
+namespace {
+
+struct trace_event {
+    std::string name;
+    double begin_us;
+    double duration_us;
+    unsigned thread;
+    std::size_t size;
+    bool has_size;
+};
+
+std::atomic<bool> enabled{false};
+std::mutex events_lock;
+std::vector<trace_event> events;
+std::ofstream trace_file;
+const auto epoch = std::chrono::steady_clock::now();
+
+double now_us(){
+    return std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - epoch).count();
+}
+
+//Small sequential ids read better in the trace viewer than hashed std::thread::id.
+unsigned thread_index(){
+    static std::atomic<unsigned> next_index{0};
+    thread_local unsigned index = next_index++;
+    return index;
+}
+
+void write_escaped(std::ostream& out, const std::string& str){
+    for (auto c : str){
+        if (c == '"' || c == '\\'){
+            out << '\\';
+        }
+        out << c;
+    }
+}
+
+}
+
+bool start_tracing(const std::string& path){
+    trace_file.open(path);
+    if (!trace_file){
+        return false;
+    }
+    //Timestamps are in microseconds since start, so long runs would lose precision in scientific notation.
+    trace_file << std::fixed << std::setprecision(3);
+    events.reserve(1 << 12);
+    enabled = true;
+    return true;
+}
+
+void stop_tracing(){
+    if (!enabled){
+        return;
+    }
+    enabled = false;
+
+    std::lock_guard<std::mutex> lock(events_lock);
+    trace_file << "{\"traceEvents\":[\n";
+    for (std::size_t i = 0; i < events.size(); ++i){
+        const auto& e = events[i];
+        trace_file << "{\"name\":\"";
+        write_escaped(trace_file, e.name);
+        trace_file << "\",\"ph\":\"X\",\"pid\":1,\"tid\":" << e.thread
+                   << ",\"ts\":" << e.begin_us << ",\"dur\":" << e.duration_us;
+        if (e.has_size){
+            trace_file << ",\"args\":{\"size\":" << e.size << '}';
+        }
+        trace_file << (i + 1 == events.size() ? "}\n" : "},\n");
+    }
+    trace_file << "],\"displayTimeUnit\":\"ms\"}\n";
+    trace_file.close();
+    events.clear();
+}
+
+trace_phase::trace_phase(const char* name){
+    next(name);
+}
+
+trace_phase::trace_phase(const char* name, std::size_t size)
+:size{size}, has_size{true}{
+    next(name);
+}
+
+trace_phase::~trace_phase(){
+    end();
+}
+
+void trace_phase::next(const char* next_name){
+    if (!enabled.load(std::memory_order_relaxed)){
+        return;
+    }
+    end();
+    name = next_name;
+    begin_us = now_us();
+}
+
+void trace_phase::end(){
+    if (!name){
+        return;
+    }
+    auto end_us = now_us();
+    {
+        std::lock_guard<std::mutex> lock(events_lock);
+        events.push_back({name, begin_us, end_us - begin_us, thread_index(), size, has_size});
+    }
+    name = nullptr;
+}
+
+#else
+
+bool start_tracing(const std::string&){
+    return false;
+}
+
+void stop_tracing(){}
+
+#endif
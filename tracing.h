@@ -0,0 +1,60 @@
+#pragma once
+#ifndef WTF_TRACING
+#define WTF_TRACING
+
+#include <cstddef>
+#include <string>
+
+/* Phase level tracing of benchmark runs, written out in Chrome trace event format, that Perfetto and chrome://tracing open.
+ *
+ * Tracing has to be started explicitly, until then every trace_phase only checks a flag.
+ * Defining WTF_DISABLE_TRACING compiles all of it out.
+ */
+
+//Returns false if the trace file cannot be opened, or tracing was compiled out.
+bool start_tracing(const std::string& path);
+//Writes out all the recorded events and closes the trace file.
+void stop_tracing();
+
+#ifndef WTF_DISABLE_TRACING
+
+/* Records a sequence of back to back phases, each one ending when the next one starts.
+ *
+ * The last phase ends with the destruction, so a phase can be opened right before declaring a variable
+ * without having to put the variable into a separate scope.
+ * If size is given, it is attached to every phase as an argument.
+ */
+class trace_phase {
+public:
+    explicit trace_phase(const char* name);
+    trace_phase(const char* name, std::size_t size);
+    ~trace_phase();
+
+    trace_phase(const trace_phase&) = delete;
+    trace_phase& operator=(const trace_phase&) = delete;
+
+    void next(const char* name);
+    //Ends the current phase early, without starting another one.
+    void end();
+
+private:
+    const char* name = nullptr;
+    std::size_t size = 0;
+    bool has_size = false;
+    double begin_us = 0;
+};
+
+#else
+
+class trace_phase {
+public:
+    explicit trace_phase(const char*){}
+    trace_phase(const char*, std::size_t){}
+
+    void next(const char*){}
+    void end(){}
+};
+
+#endif
+
+#endif
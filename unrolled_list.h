@@ -0,0 +1,205 @@
+#pragma once
+#ifndef WTF_UNROLLED_LIST
+#define WTF_UNROLLED_LIST
+
+#include <algorithm>
+#include <iterator>
+#include <cstdint>
+#include <new>
+
+#include "aligned_allocator.h"
+
+/* Doubly linked list of nodes, each holding as many elements as fit into NodeBytes.
+ *
+ * Nodes are cache line aligned, so with the default size every node is exactly one line.
+ * Inserting into a full node splits it in half, so iterators are invalidated by insertion,
+ * but unlike a vector, insertion only moves elements of a single node.
+ */
+template <typename T, std::size_t NodeBytes = cache_line_size>
+class unrolled_list {
+    struct links {
+        links* prev;
+        links* next;
+    };
+
+    static constexpr std::size_t header_size = sizeof(links) + sizeof(std::uint32_t);
+    static constexpr std::size_t capacity = NodeBytes > header_size + sizeof(T) ? (NodeBytes - header_size) / sizeof(T) : 1;
+
+    struct node : links {
+        std::uint32_t count = 0;
+        T elems[capacity];
+    };
+
+public:
+    using value_type = T;
+
+    class iterator {
+    public:
+        using iterator_category = std::bidirectional_iterator_tag;
+        using value_type = T;
+        using difference_type = std::ptrdiff_t;
+        using pointer = T*;
+        using reference = T&;
+
+        iterator(){}
+        iterator(links* current, std::size_t position)
+        :current{current}, position{position}{}
+
+        reference operator*() const {
+            return static_cast<node*>(current)->elems[position];
+        }
+
+        pointer operator->() const {
+            return &**this;
+        }
+
+        iterator& operator++(){
+            if (++position == static_cast<node*>(current)->count){
+                current = current->next;
+                position = 0;
+            }
+            return *this;
+        }
+
+        iterator operator++(int){
+            auto temp = *this;
+            ++*this;
+            return temp;
+        }
+
+        iterator& operator--(){
+            if (position == 0){
+                current = current->prev;
+                position = static_cast<node*>(current)->count;
+            }
+            --position;
+            return *this;
+        }
+
+        iterator operator--(int){
+            auto temp = *this;
+            --*this;
+            return temp;
+        }
+
+        bool operator==(const iterator& rhs) const {
+            return current == rhs.current && position == rhs.position;
+        }
+
+        bool operator!=(const iterator& rhs) const {
+            return !(*this == rhs);
+        }
+
+    private:
+        friend class unrolled_list;
+        links* current = nullptr;
+        std::size_t position = 0;
+    };
+
+    using reverse_iterator = std::reverse_iterator<iterator>;
+
+    unrolled_list(){
+        sentinel.prev = sentinel.next = &sentinel;
+    }
+
+    //Packs the elements into as few nodes as possible.
+    template <typename InputIterator>
+    unrolled_list(InputIterator first, InputIterator last)
+    :unrolled_list(){
+        for (; first != last; ++first){
+            auto tail = static_cast<node*>(sentinel.prev);
+            if (sentinel.prev == &sentinel || tail->count == capacity){
+                tail = link_after(sentinel.prev);
+            }
+            tail->elems[tail->count++] = *first;
+            ++elements;
+        }
+    }
+
+    unrolled_list(const unrolled_list&) = delete;
+    unrolled_list& operator=(const unrolled_list&) = delete;
+
+    ~unrolled_list(){
+        auto current = sentinel.next;
+        while (current != &sentinel){
+            auto next = current->next;
+            free_node(static_cast<node*>(current));
+            current = next;
+        }
+    }
+
+    iterator insert(iterator pos, const T& value){
+        ++elements;
+        if (pos.current == &sentinel){
+            auto tail = static_cast<node*>(sentinel.prev);
+            if (sentinel.prev == &sentinel || tail->count == capacity){
+                tail = link_after(sentinel.prev);
+            }
+            tail->elems[tail->count] = value;
+            return iterator(tail, tail->count++);
+        }
+
+        auto current = static_cast<node*>(pos.current);
+        auto position = pos.position;
+        if (current->count == capacity){
+            auto sibling = link_after(current);
+            const auto mid = capacity / 2;
+            std::move(current->elems + mid, current->elems + capacity, sibling->elems);
+            sibling->count = capacity - mid;
+            current->count = mid;
+            if (position > mid){
+                current = sibling;
+                position -= mid;
+            }
+        }
+
+        std::move_backward(current->elems + position, current->elems + current->count, current->elems + current->count + 1);
+        current->elems[position] = value;
+        ++current->count;
+        return iterator(current, position);
+    }
+
+    void push_back(const T& value){
+        insert(end(), value);
+    }
+
+    std::size_t size() const {
+        return elements;
+    }
+
+    iterator begin(){
+        return iterator(sentinel.next, 0);
+    }
+
+    iterator end(){
+        return iterator(&sentinel, 0);
+    }
+
+    reverse_iterator rbegin(){
+        return reverse_iterator(end());
+    }
+
+    reverse_iterator rend(){
+        return reverse_iterator(begin());
+    }
+
+private:
+    node* link_after(links* prev){
+        auto fresh = new (aligned_allocator<node>().allocate(1)) node();
+        fresh->prev = prev;
+        fresh->next = prev->next;
+        prev->next->prev = fresh;
+        prev->next = fresh;
+        return fresh;
+    }
+
+    static void free_node(node* n){
+        n->~node();
+        aligned_allocator<node>().deallocate(n, 1);
+    }
+
+    links sentinel;
+    std::size_t elements = 0;
+};
+
+#endif
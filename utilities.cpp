@@ -1,5 +1,16 @@
 #include "utilities.h"
 
+#include <algorithm>
+#include <fstream>
+#include <mutex>
+#include <sstream>
+#include <string>
+
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#endif
+
 uint32_t lower_power_of_2(uint32_t x){
     if (x == 0){
         //well, this is a good question... should be UINT_MAX strictly speaking, but that would be rather surprising.
@@ -29,3 +40,158 @@ uint32_t upper_power_of_2(uint32_t x){
     return x;
 
 }
+
+#ifdef __linux__
+namespace {
+
+cpu_set_t initial_affinity(){
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    if (sched_getaffinity(0, sizeof(set), &set) != 0){
+        const unsigned cpus = std::min(std::max(std::thread::hardware_concurrency(), 1u), unsigned(CPU_SETSIZE));
+        for (unsigned cpu = 0; cpu < cpus; ++cpu){
+            CPU_SET(cpu, &set);
+        }
+    }
+    return set;
+}
+
+//Initialized before main, so before anything gets pinned.
+const cpu_set_t process_affinity = initial_affinity();
+
+bool pin_to_cpu(pthread_t thread, unsigned cpu){
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(cpu, &set);
+    return pthread_setaffinity_np(thread, sizeof(set), &set) == 0;
+}
+
+}
+
+bool pin_thread(std::thread& thread, unsigned cpu){
+    return pin_to_cpu(thread.native_handle(), cpu);
+}
+
+bool pin_current_thread(unsigned cpu){
+    return pin_to_cpu(pthread_self(), cpu);
+}
+
+unsigned current_cpu(){
+    int cpu = sched_getcpu();
+    return cpu < 0 ? 0 : static_cast<unsigned>(cpu);
+}
+
+std::vector<unsigned> allowed_cpus(){
+    std::vector<unsigned> cpus;
+    for (unsigned cpu = 0; cpu < CPU_SETSIZE; ++cpu){
+        if (CPU_ISSET(cpu, &process_affinity)){
+            cpus.push_back(cpu);
+        }
+    }
+    return cpus;
+}
+
+bool unpin_current_thread(){
+    cpu_set_t current;
+    if (pthread_getaffinity_np(pthread_self(), sizeof(current), &current) == 0 && CPU_EQUAL(&current, &process_affinity)){
+        return true;
+    }
+    return pthread_setaffinity_np(pthread_self(), sizeof(process_affinity), &process_affinity) == 0;
+}
+#else
+bool pin_thread(std::thread&, unsigned){
+    return false;
+}
+
+bool pin_current_thread(unsigned){
+    return false;
+}
+
+unsigned current_cpu(){
+    return 0;
+}
+
+std::vector<unsigned> allowed_cpus(){
+    std::vector<unsigned> cpus(std::max(std::thread::hardware_concurrency(), 1u));
+    for (unsigned cpu = 0; cpu < cpus.size(); ++cpu){
+        cpus[cpu] = cpu;
+    }
+    return cpus;
+}
+
+//Nothing could have been pinned, so there is nothing to undo.
+bool unpin_current_thread(){
+    return true;
+}
+#endif
+
+namespace {
+
+#ifdef __linux__
+//Lowest CPU of a list like "0-3,8-11", or fallback if the file is missing or malformed.
+unsigned first_listed_cpu(const std::string& path, unsigned fallback){
+    std::ifstream in(path);
+    unsigned cpu = 0;
+    if (in >> cpu){
+        return cpu;
+    }
+    return fallback;
+}
+
+//Last level cache is the highest level cache listed for the CPU, it is identified by the lowest CPU sharing it.
+unsigned llc_of(unsigned cpu){
+    std::ostringstream base;
+    base << "/sys/devices/system/cpu/cpu" << cpu << "/cache/index";
+    unsigned best_level = 0;
+    unsigned llc = 0;
+    for (int index = 0; ; ++index){
+        auto dir = base.str() + std::to_string(index);
+        unsigned level = 0;
+        std::ifstream in(dir + "/level");
+        if (!(in >> level)){
+            break;
+        }
+        if (level > best_level){
+            best_level = level;
+            llc = first_listed_cpu(dir + "/shared_cpu_list", 0);
+        }
+    }
+    return llc;
+}
+#endif
+
+std::mutex reserved_mutex;
+std::vector<unsigned> reserved;
+
+}
+
+std::vector<cpu_info> cpu_topology(){
+    std::vector<cpu_info> topology;
+    for (auto cpu : allowed_cpus()){
+#ifdef __linux__
+        auto dir = "/sys/devices/system/cpu/cpu" + std::to_string(cpu) + "/topology/";
+        topology.push_back(cpu_info{cpu, first_listed_cpu(dir + "thread_siblings_list", cpu), llc_of(cpu), first_listed_cpu(dir + "core_siblings_list", 0)});
+#else
+        topology.push_back(cpu_info{cpu, cpu, 0, 0});
+#endif
+    }
+    return topology;
+}
+
+void reserve_cpu(unsigned cpu){
+    std::lock_guard<std::mutex> lock(reserved_mutex);
+    reserved.push_back(cpu);
+}
+
+void release_cpu(unsigned cpu){
+    std::lock_guard<std::mutex> lock(reserved_mutex);
+    auto it = std::find(begin(reserved), end(reserved), cpu);
+    if (it != end(reserved)){
+        reserved.erase(it);
+    }
+}
+
+bool cpu_reserved(unsigned cpu){
+    std::lock_guard<std::mutex> lock(reserved_mutex);
+    return std::find(begin(reserved), end(reserved), cpu) != end(reserved);
+}
@@ -3,6 +3,8 @@
 #define WTF_CACHE_UTILITIES
 
 #include <cstdint>
+#include <thread>
+#include <vector>
 
 constexpr bool is_power_of_2(uint32_t x){
     return (x & (x - 1)) == 0;
@@ -11,4 +13,39 @@ constexpr bool is_power_of_2(uint32_t x){
 uint32_t lower_power_of_2(uint32_t x);
 uint32_t upper_power_of_2(uint32_t x);
 
+//Pin given thread to a single CPU. Only Linux is supported, elsewhere these just return false.
+bool pin_thread(std::thread& thread, unsigned cpu);
+bool pin_current_thread(unsigned cpu);
+//CPU the calling thread runs on right now, or 0 if it cannot be found out.
+unsigned current_cpu();
+/* CPUs the process was allowed to run on when it started, in increasing order.
+ *
+ * This is captured before main, so it stays correct even after the main thread was pinned.
+ * Outside of Linux, it is every CPU reported by std::thread::hardware_concurrency.
+ */
+std::vector<unsigned> allowed_cpus();
+//Lets the calling thread run on all of allowed_cpus again, threads otherwise inherit pinning from the thread that started them.
+bool unpin_current_thread();
+
+/* Where a CPU sits in the machine. Every id is the lowest CPU number of the group,
+ * so two CPUs share a core, a last level cache or a package exactly when their ids are equal.
+ */
+struct cpu_info {
+    unsigned cpu;
+    unsigned core;
+    unsigned llc;
+    unsigned package;
+};
+
+/* Topology of allowed_cpus, read from /sys/devices/system/cpu.
+ *
+ * Where it cannot be read, every CPU is taken as its own core and all of them share one LLC and package.
+ */
+std::vector<cpu_info> cpu_topology();
+
+//CPUs busy with background work, like noise threads, so that benchmarks do not place their own threads there.
+void reserve_cpu(unsigned cpu);
+void release_cpu(unsigned cpu);
+bool cpu_reserved(unsigned cpu);
+
 #endif